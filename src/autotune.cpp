@@ -0,0 +1,356 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Measures the CRC32 B settings for this host and saves them for
+Tune_Load(), see util_tune.h:
+
+  1. kernel, kernel_small, small_size
+     Every CRC32 B kernel in crc32_kernels.h is timed at 16 B .. 1 MB.
+     kernel is the fastest at 1 MB, kernel_small the fastest at 64 B, and
+     small_size the largest length where kernel_small still wins.
+
+  2. chunk
+     A buffer larger than the last level cache is copied into a chunk
+     and hashed, as a file read would, for chunks of 4 KB .. 16 MB. The
+     best one usually fits in L2.
+
+  3. threads
+     Chunks of the buffer are hashed on 1, 2, 4, ... all threads. More
+     threads than the memory bandwidth can feed, or SMT siblings sharing
+     the load ports, don't help, the fewest threads within 2% win.
+
+Kernels added to crc32_kernels.h are candidates without changes here.
+
+CRC32_PROFILE=1 shows how long each phase took, see util_profile.h.
+
+*/
+
+// Defines
+#define USE_OMP 1
+#if _WIN32
+    #define _CRT_SECURE_NO_WARNINGS 1
+#endif
+#ifndef USE_ZLIB
+    #define USE_ZLIB 1
+#endif
+
+// Includes
+    #include "common.cpp"
+
+// BEGIN OMP
+#if USE_OMP
+    #include <omp.h>
+#endif
+    #include "util_threads.h"
+// END OMP
+    #include "util_bench.h"
+    #include "util_profile.h"
+#if USE_ZLIB
+    #include <zlib.h>
+#endif
+    #include "crc32_kernels.h"
+    #include "util_tune.h"
+
+// Consts
+    const uint64_t TRIAL_NS    = 200000; // 0.2 ms
+    const size_t   SMALL_SIZE  = 64;
+    const size_t   LARGE_SIZE  = 1 << 20;
+    const size_t   MIN_CHUNK   = 4 << 10;
+    const size_t   MAX_CHUNK   = 16 << 20;
+    const double   SAME_THREAD = 1.02;   // fewer threads win within 2%
+
+// Vars
+    int            gnTrials    = 9;         // -t
+    size_t         gnBuffer    = 256 << 20; // -l, > LLC
+    volatile uint32_t gnSink   = 0;
+
+// Implementation
+
+    struct TuneCall
+    {
+        Crc32Func            func  ;
+        const unsigned char *buffer;
+        size_t               size  ;
+        unsigned char       *chunk ; // read into
+        size_t               nChunk;
+    };
+
+    // ========================================================================
+    void Tune_BodyKernel( void *context, uint64_t nCalls )
+    {
+        const TuneCall *call = (const TuneCall*) context;
+        uint32_t        sum  = 0;
+
+        while( nCalls-- )
+            sum += call->func( call->size, call->buffer );
+        gnSink += sum;
+    }
+
+    // Copy the buffer in chunks, as fread() would, and hash each
+    // ========================================================================
+    void Tune_BodyChunk( void *context, uint64_t nCalls )
+    {
+        const TuneCall *call = (const TuneCall*) context;
+        uint32_t        sum  = 0;
+
+        while( nCalls-- )
+            for( size_t offset = 0; offset < call->size; offset += call->nChunk )
+            {
+                const size_t size = (call->size - offset < call->nChunk) ? call->size - offset : call->nChunk;
+                memcpy( call->chunk, call->buffer + offset, size );
+                sum += call->func( size, call->chunk );
+            }
+        gnSink += sum;
+    }
+
+    // Hash the chunks of the buffer on the active threads
+    // ========================================================================
+    void Tune_BodyThreads( void *context, uint64_t nCalls )
+    {
+        const TuneCall *call    = (const TuneCall*) context;
+        const int64_t   nChunks = (int64_t)((call->size + call->nChunk - 1) / call->nChunk);
+        uint32_t        sum     = 0;
+
+        while( nCalls-- )
+        {
+#pragma omp parallel for schedule(dynamic,1) reduction(+:sum)
+            for( int64_t iChunk = 0; iChunk < nChunks; iChunk++ )
+            {
+                const size_t offset = (size_t) iChunk * call->nChunk;
+                const size_t size   = (call->size - offset < call->nChunk) ? call->size - offset : call->nChunk;
+                sum += call->func( size, call->buffer + offset );
+            }
+        }
+        gnSink += sum;
+    }
+
+    // @return median GB/s
+    // ========================================================================
+    double Tune_Measure( BenchBody_t body, TuneCall *call )
+    {
+        PROFILE_SCOPE( "measure" );
+        BenchStats stats;
+        const uint64_t nCalls = Bench_Calibrate( body, call, TRIAL_NS );
+        Bench_Measure( &stats, body, call, nCalls, 1, gnTrials );
+        return call->size / stats.median_ns;
+    }
+
+// ========================================================================
+int Usage()
+{
+    printf(
+"Measure the fastest CRC32 B kernel, chunk size, and thread count for this host\n"
+"\n"
+"Usage: autotune [options]\n"
+"\n"
+#if USE_OMP
+"    -j#         Most threads to try (default all)\n"
+#endif
+"    -l<MB>      Buffer for chunk and thread runs (default 256)\n"
+"    -n          Don't save, only show the results\n"
+"    -o<file>    Save to file (default $CRC32_TUNE, else crc32.tune)\n"
+"    -t#         Timed trials per measurement (default 9)\n"
+"\n"
+"Examples:\n"
+"    ./autotune\n"
+"    CRC32_TUNE=/etc/crc32.tune ./autotune\n"
+    );
+    return 0;
+}
+
+// ========================================================================
+int main( const int nArg, const char *aArg[] )
+{
+    Profile_Init();
+    PROFILE_SCOPE( "autotune" );
+
+    {
+        PROFILE_SCOPE( "table init" );
+        common_init( false );
+    }
+
+#if USE_OMP
+    Threads_Default();
+#endif // USE_OMP
+
+    const char *pFile  = Tune_FileName();
+    bool        bSave  = true;
+
+    for( int iArg = 1; iArg < nArg; iArg++ )
+    {
+        const char *pArg = aArg[ iArg ];
+        if (pArg[0] != '-')
+            return Usage();
+        pArg++;
+
+        if (*pArg == '?')
+            return Usage();
+        else
+#if USE_OMP
+        if (*pArg == 'j')
+        {
+            int i = atoi( pArg+1 );
+            if( i > 0 )
+                gnThreadsActive = i;
+            if( gnThreadsActive > MAX_THREADS )
+                gnThreadsActive = MAX_THREADS;
+        }
+        else
+#endif // USE_OMP
+        if (*pArg == 'l')
+            gnBuffer = (size_t) atoi( pArg+1 ) << 20;
+        else
+        if (*pArg == 'n')
+            bSave = false;
+        else
+        if (*pArg == 'o')
+            pFile = pArg+1;
+        else
+        if (*pArg == 't')
+            gnTrials = atoi( pArg+1 );
+        else
+            return Usage();
+    }
+
+#if USE_OMP
+    Threads_Set();
+#endif // USE_OMP
+
+    if (gnBuffer < MAX_CHUNK)
+        gnBuffer = MAX_CHUNK;
+
+    char brand[ 64 ];
+    Cpu_Brand( brand );
+    printf( "CPU: %s, %d threads\n", brand, gnThreadsActive );
+
+    unsigned char *pBuffer = (unsigned char*) malloc( gnBuffer );
+    unsigned char *pChunk  = (unsigned char*) malloc( MAX_CHUNK );
+    if (!pBuffer || !pChunk)
+    {
+        printf( "ERROR: Couldn't allocate %llu MB\n", (unsigned long long)(gnBuffer >> 20) );
+        return 1;
+    }
+    for( size_t offset = 0; offset < gnBuffer; offset++ )
+        pBuffer[ offset ] = (unsigned char)(offset * 0x9E3779B1u >> 24);
+
+    // 1. Kernels
+    const Crc32Kernel *aCandidate[ 64 ];
+    int                nCandidate = 0;
+    for( int iKernel = 0; (iKernel < nKernels) && (nCandidate < 64); iKernel++ )
+    {
+        const Crc32Kernel *kernel = &aKernels[ iKernel ];
+        if ((kernel->reference == reference_crc32b) && (kernel->func( 9, (const unsigned char*) CRC32_CHECK_TXT ) == kernel->check))
+            aCandidate[ nCandidate++ ] = kernel;
+    }
+
+    const int nSizes = 9; // 16 B .. 1 MB
+    double    aRate[ 64 ][ nSizes ];
+
+    printf( "\n1. Kernels, GB/s\n%-24s", "" );
+    for( int iSize = 0; iSize < nSizes; iSize++ )
+        printf( " %8u", 16u << (2*iSize) );
+    printf( "\n" );
+
+    for( int iCandidate = 0; iCandidate < nCandidate; iCandidate++ )
+    {
+        PROFILE_SCOPE( "1. kernels" );
+        printf( "%-24s", aCandidate[ iCandidate ]->name );
+        for( int iSize = 0; iSize < nSizes; iSize++ )
+        {
+            TuneCall call = { aCandidate[ iCandidate ]->func, pBuffer, (size_t) 16 << (2*iSize), NULL, 0 };
+            aRate[ iCandidate ][ iSize ] = Tune_Measure( Tune_BodyKernel, &call );
+            printf( " %8.3f", aRate[ iCandidate ][ iSize ] );
+            fflush( stdout );
+        }
+        printf( "\n" );
+    }
+
+    // Fastest at the small and large end
+    int iSmall = 0, iLarge = 0;
+    const int iSizeSmall = 1; // 64 B
+    const int iSizeLarge = nSizes - 1;
+    for( int iCandidate = 1; iCandidate < nCandidate; iCandidate++ )
+    {
+        if (aRate[ iCandidate ][ iSizeSmall ] > aRate[ iSmall ][ iSizeSmall ]) iSmall = iCandidate;
+        if (aRate[ iCandidate ][ iSizeLarge ] > aRate[ iLarge ][ iSizeLarge ]) iLarge = iCandidate;
+    }
+
+    size_t smallSize = 0;
+    if (iSmall != iLarge)
+        for( int iSize = 0; (iSize < nSizes) && (aRate[ iSmall ][ iSize ] > aRate[ iLarge ][ iSize ]); iSize++ )
+            smallSize = (size_t) 16 << (2*iSize);
+
+    strcpy( gTune.kernel      , aCandidate[ iLarge ]->name );
+    strcpy( gTune.kernel_small, aCandidate[ iSmall ]->name );
+    gTune.small_size = smallSize;
+    gTune.func       = aCandidate[ iLarge ]->func;
+    gTune.func_small = aCandidate[ iSmall ]->func;
+
+    // 2. Chunk size
+    printf( "\n2. Chunk size, %s, %llu MB copied and hashed, GB/s\n", gTune.kernel, (unsigned long long)(gnBuffer >> 20) );
+
+    double bestChunk = 0.;
+    for( size_t nChunk = MIN_CHUNK; nChunk <= MAX_CHUNK; nChunk *= 2 )
+    {
+        PROFILE_SCOPE( "2. chunk size" );
+        TuneCall     call = { gTune.func, pBuffer, gnBuffer, pChunk, nChunk };
+        const double rate = Tune_Measure( Tune_BodyChunk, &call );
+        printf( "    %8llu KB  %8.3f\n", (unsigned long long)(nChunk >> 10), rate );
+        fflush( stdout );
+
+        if (rate > bestChunk)
+        {
+            bestChunk   = rate;
+            gTune.chunk = nChunk;
+        }
+    }
+
+    // 3. Threads
+    printf( "\n3. Threads, %s, %llu KB chunks, GB/s\n", gTune.kernel, (unsigned long long)(gTune.chunk >> 10) );
+
+    const int nMaxThreads = gnThreadsActive;
+    double    bestThreads = 0.;
+    for( int nThreads = 1; nThreads <= nMaxThreads; nThreads = (nThreads*2 > nMaxThreads && nThreads < nMaxThreads) ? nMaxThreads : nThreads*2 )
+    {
+        PROFILE_SCOPE( "3. threads" );
+#if USE_OMP
+        omp_set_num_threads( nThreads );
+#endif
+        TuneCall     call = { gTune.func, pBuffer, gnBuffer, NULL, gTune.chunk };
+        const double rate = Tune_Measure( Tune_BodyThreads, &call );
+        printf( "    %8d     %8.3f\n", nThreads, rate );
+        fflush( stdout );
+
+        if (rate > bestThreads * SAME_THREAD)
+        {
+            bestThreads   = rate;
+            gTune.threads = nThreads;
+        }
+    }
+
+    printf( "\nkernel       = %s\n"  , gTune.kernel       );
+    printf( "kernel_small = %s\n"  , gTune.kernel_small );
+    printf( "small_size   = %llu\n", (unsigned long long) gTune.small_size );
+    printf( "chunk        = %llu\n", (unsigned long long) gTune.chunk      );
+    printf( "threads      = %d\n"  , gTune.threads      );
+
+    free( pChunk  );
+    free( pBuffer );
+
+    if (bSave)
+    {
+        if (!Tune_Save( pFile, brand ))
+        {
+            printf( "ERROR: Couldn't write '%s'\n", pFile );
+            return 1;
+        }
+        printf( "Saved to '%s'\n", pFile );
+    }
+
+    return 0;
+}
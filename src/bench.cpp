@@ -0,0 +1,657 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Microbenchmark of every CRC32 kernel over buffer sizes from 16 bytes up,
+warm, cold, or shared cache, aligned or unaligned input.
+
+Each measurement runs warmup trials, then repeated trials of enough calls
+to take TRIAL_NS, see util_bench.h. GB/s and TSC cycles/byte are of the
+median trial, with the min and p99 per call alongside. TSC cycles tick at
+the nominal clock, not the current one, so compare cycles/byte on one
+machine.
+
+Cold cache walks a buffer larger than the last level cache before each
+trial of a single call, only the kernel is timed.
+
+Shared cache, -p, walks a working set the size of L1, 32 KB or -p48K,
+before every call and times both. The walk alone is subtracted, what remains is the kernel
+plus the misses it causes its caller: its table evicted the working set,
+and the working set evicted its table. It ranks kernels for short
+messages hashed between other work, where a warm benchmark flatters big
+tables.
+
+The system zlib crc32() is included as a reference point.
+
+With -e each measurement is repeated under the hardware counters, see
+util_perf.h, and IPC and misses per byte are printed below it.
+
+With -o the results are also written as JSON, one result per line:
+
+    { "cpu": "...", "results": [
+      { "kernel": "crc32_100", "size": 16, "cache": "warm", "align": "aligned", "gbps": 0.97, ... }
+    ] }
+
+and -C compares a baseline against another run, exiting with 1 if any
+kernel's median GB/s dropped by more than the -T threshold.
+
+CRC32_PROFILE=1 shows how long calibration, timing, and each kernel
+took, see util_profile.h.
+
+*/
+
+// Defines
+#if _WIN32
+    #define _CRT_SECURE_NO_WARNINGS 1
+#endif
+#ifndef USE_ZLIB
+    #define USE_ZLIB 1
+#endif
+
+// Includes
+    #include "common.cpp"
+    #include "util_bench.h"
+    #include "util_profile.h"
+    #include "util_perf.h"
+#if USE_ZLIB
+    #include <zlib.h>
+#endif
+    #include "crc32_kernels.h"
+
+// Consts
+    const uint64_t TRIAL_NS  = 200000;   // 0.2 ms
+    const uint64_t BUDGET_NS = 2000000000ull; // fewer trials if one is slow
+    const size_t   COLD_SIZE = 64 << 20; // > LLC
+    const size_t   SHARED_SIZE = 32 << 10; // -p default, ~ L1D
+    const int      MAX_RESULTS = 4096;
+    const size_t MAX_KERNELS = 64;
+    const int      MAX_NAME  = 64;     // kernel name in a JSON result
+
+// Types
+    enum BenchCache
+    {
+         CACHE_WARM
+        ,CACHE_COLD
+        ,CACHE_SHARED
+        ,NUM_CACHE
+    };
+
+    struct BenchResult
+    {
+        char     kernel[ MAX_NAME ];
+        uint64_t size;
+        int      cache; // BenchCache
+        bool     unaligned;
+        double   gbps;
+        double   cycles_per_byte;
+        double   min_ns, median_ns, p99_ns;
+    };
+
+// Vars
+    const char    *gpFilter   = NULL;  // -k
+    size_t         gnMinSize  = 16;
+    size_t         gnMaxSize  = 64 << 20;
+    bool           gbCold     = false; // -c
+    bool           gbShared   = false; // -p
+    size_t         gnShared   = SHARED_SIZE;
+    bool           gbUnalign  = false; // -u
+    int            gnTrials   = 31;    // -t
+    int            gnWarmup   = 3;     // -w
+    bool           gbPerf     = false; // -e
+    bool           gbLatency  = false; // -H, see util_latency.h
+    PerfCounters   gPerf;
+
+    const char    *gpJsonFile = NULL;  // -o
+    FILE          *gpJson     = NULL;
+    int            gnJson     = 0;     // results written
+
+    unsigned char *gpCold     = NULL;
+    unsigned char *gpShared   = NULL;
+    volatile uint32_t gnSink  = 0;     // keeps results alive
+
+    const char    *gaCacheName[ NUM_CACHE ] = { "warm", "cold", "shared" };
+
+// Implementation
+
+    struct BenchCall
+    {
+        const Crc32Kernel   *kernel;
+        const unsigned char *buffer;
+        size_t               size  ;
+    };
+
+    // ========================================================================
+    void Bench_Body( void *context, uint64_t nCalls )
+    {
+        const BenchCall *call = (const BenchCall*) context;
+        uint32_t         sum  = 0;
+
+        while( nCalls-- )
+            sum += call->kernel->func( call->size, call->buffer );
+        gnSink += sum;
+    }
+
+    // Caller's working set
+    // ========================================================================
+    inline uint32_t Bench_Touch()
+    {
+        uint32_t sum = 0;
+        for( size_t offset = 0; offset < gnShared; offset += 64 )
+            sum += gpShared[ offset ];
+        return sum;
+    }
+
+    // ========================================================================
+    void Bench_BodyShared( void *context, uint64_t nCalls )
+    {
+        const BenchCall *call = (const BenchCall*) context;
+        uint32_t         sum  = 0;
+
+        while( nCalls-- )
+        {
+            sum += Bench_Touch();
+            sum += call->kernel->func( call->size, call->buffer );
+        }
+        gnSink += sum;
+    }
+
+    // ========================================================================
+    void Bench_BodyTouch( void *, uint64_t nCalls )
+    {
+        uint32_t sum = 0;
+        while( nCalls-- )
+            sum += Bench_Touch();
+        gnSink += sum;
+    }
+
+    // Touch enough memory to evict buffer from every cache level
+    // ========================================================================
+    void Bench_Evict( void *, uint64_t )
+    {
+        uint32_t sum = 0;
+        for( size_t offset = 0; offset < COLD_SIZE; offset += 64 )
+        {
+            gpCold[ offset ]++;
+            sum += gpCold[ offset ];
+        }
+        gnSink += sum;
+    }
+
+    // ========================================================================
+    void Bench_Run( const Crc32Kernel *kernel, const unsigned char *buffer, const size_t size, const int cache, const bool bUnalign )
+    {
+        BenchCall   call  = { kernel, buffer, size };
+        BenchStats  stats;
+        const bool  bCold = (cache == CACHE_COLD);
+        BenchBody_t body  = (cache == CACHE_SHARED) ? Bench_BodyShared : Bench_Body;
+
+        uint64_t   nTrialNs;
+        uint64_t   nCalls;
+        {
+            PROFILE_SCOPE( "calibrate" );
+            nCalls = Bench_Calibrate( body, &call, TRIAL_NS, &nTrialNs );
+        }
+        int        nTrials = gnTrials;
+        int        nWarmup = gnWarmup;
+
+        // Slow kernels on large buffers, i.e. formula on 1 GB, take seconds per call
+        if (nTrialNs * (nTrials + nWarmup) > BUDGET_NS)
+        {
+            nTrials = (int)(BUDGET_NS / nTrialNs);
+            if (nTrials < 3)
+                nTrials = 3;
+            nWarmup = 0; // calibration already warmed up
+        }
+
+        if (bCold)
+            nCalls = 1;
+
+        {
+            PROFILE_SCOPE( "measure" );
+            if (bCold)
+                Bench_Measure( &stats, Bench_Body, &call, nCalls, 1, nTrials, Bench_Evict );
+            else
+                Bench_Measure( &stats, body, &call, nCalls, nWarmup, nTrials );
+        }
+
+        // Less the caller's own time, with nothing evicting its working set
+        if (cache == CACHE_SHARED)
+        {
+            PROFILE_SCOPE( "measure touch" );
+            BenchStats touch;
+            Bench_Measure( &touch, Bench_BodyTouch, NULL, nCalls, nWarmup, nTrials );
+
+            // Out of order execution can hide a short kernel under the walk
+            stats.min_ns        = (stats.min_ns    > touch.median_ns) ? stats.min_ns    - touch.median_ns : 0.;
+            stats.median_ns     = (stats.median_ns > touch.median_ns) ? stats.median_ns - touch.median_ns : 0.1;
+            stats.p99_ns        = (stats.p99_ns    > touch.median_ns) ? stats.p99_ns    - touch.median_ns : 0.;
+            stats.median_cycles = (stats.median_cycles > touch.median_cycles) ? stats.median_cycles - touch.median_cycles : 0.;
+        }
+
+        char text[ 32 ];
+        if      (size >= (1u << 30)) sprintf( text, "%4u GB", (unsigned)(size >> 30) );
+        else if (size >= (1u << 20)) sprintf( text, "%4u MB", (unsigned)(size >> 20) );
+        else if (size >= (1u << 10)) sprintf( text, "%4u KB", (unsigned)(size >> 10) );
+        else                         sprintf( text, "%4u  B", (unsigned) size );
+
+        printf( "%-24s  %s  %-6s  %-9s  %8.3f GB/s  %8.2f cycles/byte  %12.1f %12.1f %12.1f ns\n"
+            , kernel->name
+            , text
+            , gaCacheName[ cache ]
+            , bUnalign ? "unaligned" : "aligned"
+            , size / stats.median_ns
+            , stats.median_cycles / size
+            , stats.min_ns
+            , stats.median_ns
+            , stats.p99_ns
+        );
+
+        if (gpJson)
+        {
+            fprintf( gpJson, "%s  { \"kernel\": \"%s\", \"size\": %llu, \"cache\": \"%s\", \"align\": \"%s\""
+                             ", \"gbps\": %.4f, \"cycles_per_byte\": %.4f, \"min_ns\": %.1f, \"median_ns\": %.1f, \"p99_ns\": %.1f }\n"
+                , gnJson++ ? "," : " "
+                , kernel->name
+                , (unsigned long long) size
+                , gaCacheName[ cache ]
+                , bUnalign ? "unaligned" : "aligned"
+                , size / stats.median_ns
+                , stats.median_cycles / size
+                , stats.min_ns
+                , stats.median_ns
+                , stats.p99_ns
+            );
+        }
+
+        // Counted separately so reading them doesn't disturb the timing
+        if (gbPerf)
+        {
+            PROFILE_SCOPE( "perf counters" );
+            Perf_Reset( &gPerf );
+            for( int iTrial = 0; iTrial < nTrials; iTrial++ )
+            {
+                if (bCold)
+                    Bench_Evict( NULL, 1 );
+                Perf_Enable ( &gPerf );
+                    body( &call, nCalls );
+                Perf_Disable( &gPerf );
+            }
+            Perf_Read ( &gPerf );
+            Perf_Print( &gPerf, (uint64_t) size * nCalls * nTrials, "    " );
+        }
+        fflush( stdout );
+    }
+
+    // ========================================================================
+    size_t Bench_ParseSize( const char *text )
+    {
+        char  *unit;
+        size_t size = (size_t) strtoull( text, &unit, 10 );
+        switch( *unit )
+        {
+            case 'k': case 'K': size <<= 10; break;
+            case 'm': case 'M': size <<= 20; break;
+            case 'g': case 'G': size <<= 30; break;
+        }
+        return size;
+    }
+
+// Compare
+
+    // Value of "key": in a line, only for files written by -o
+    // @return false if key is missing or its value doesn't fit in size
+    // ========================================================================
+    bool Json_Field( const char *line, const char *key, char *text, const size_t size )
+    {
+        char pattern[ 64 ];
+        sprintf( pattern, "\"%s\":", key );
+
+        const char *value = strstr( line, pattern );
+        if (!value)
+            return false;
+        value += strlen( pattern );
+        while( *value == ' ' )
+            value++;
+
+        size_t length = 0;
+        if (*value == '"')
+            for( value++; value[ length ] && (value[ length ] != '"'); length++ )
+                ;
+        else
+            while( value[ length ] && (value[ length ] != ',') && (value[ length ] != ' ') && (value[ length ] != '}') )
+                length++;
+
+        if (length >= size)
+            return false;
+        memcpy( text, value, length );
+        text[ length ] = 0;
+        return true;
+    }
+
+    // @return number of results, -1 if the file couldn't be read
+    // ========================================================================
+    int Results_Load( const char *filename, BenchResult *aResult, char *cpu )
+    {
+        FILE *pFile = fopen( filename, "r" );
+        if (!pFile)
+            return -1;
+
+        char line[ 1024 ], text[ MAX_NAME ];
+        int  nResult = 0;
+
+        cpu[0] = 0;
+        while( fgets( line, sizeof( line ), pFile ) )
+        {
+            if (!cpu[0])
+                Json_Field( line, "cpu", cpu, 64 );
+
+            if (!Json_Field( line, "kernel", text, sizeof( text ) ) || (nResult >= MAX_RESULTS))
+            {
+                if (strstr( line, "\"kernel\":" ) && (nResult < MAX_RESULTS))
+                    printf( "WARNING: Skipped a result in '%s', kernel name longer than %d\n", filename, MAX_NAME - 1 );
+                continue;
+            }
+
+            BenchResult *result = &aResult[ nResult++ ];
+            memset( result, 0, sizeof( *result ) );
+            strcpy( result->kernel, text );
+
+            if (Json_Field( line, "size"           , text, sizeof( text ) )) result->size            = strtoull( text, NULL, 10 );
+            if (Json_Field( line, "cache"          , text, sizeof( text ) ))
+                for( int cache = 0; cache < NUM_CACHE; cache++ )
+                    if (!strcmp( text, gaCacheName[ cache ] ))
+                        result->cache = cache;
+            if (Json_Field( line, "align"          , text, sizeof( text ) )) result->unaligned       = !strcmp( text, "unaligned" );
+            if (Json_Field( line, "gbps"           , text, sizeof( text ) )) result->gbps            = atof( text );
+            if (Json_Field( line, "cycles_per_byte", text, sizeof( text ) )) result->cycles_per_byte = atof( text );
+            if (Json_Field( line, "min_ns"         , text, sizeof( text ) )) result->min_ns          = atof( text );
+            if (Json_Field( line, "median_ns"      , text, sizeof( text ) )) result->median_ns       = atof( text );
+            if (Json_Field( line, "p99_ns"         , text, sizeof( text ) )) result->p99_ns          = atof( text );
+        }
+
+        fclose( pFile );
+        return nResult;
+    }
+
+    // @return 1 if any kernel regressed by more than threshold percent, 2 on error
+    // ========================================================================
+    int Results_Compare( const char *baseline, const char *current, const double threshold )
+    {
+        static BenchResult aOld[ MAX_RESULTS ], aNew[ MAX_RESULTS ];
+        char cpuOld[ 64 ], cpuNew[ 64 ];
+
+        const int nOld = Results_Load( baseline, aOld, cpuOld );
+        const int nNew = Results_Load( current , aNew, cpuNew );
+        if ((nOld < 0) || (nNew < 0))
+        {
+            printf( "ERROR: Couldn't read '%s'\n", (nOld < 0) ? baseline : current );
+            return 2;
+        }
+
+        if (strcmp( cpuOld, cpuNew ))
+            printf( "WARNING: Different CPUs\n    %s\n    %s\n", cpuOld, cpuNew );
+
+        int nRegress = 0, nMatch = 0;
+        printf( "%-24s  %10s  %-6s  %-9s  %10s  %10s  %8s\n", "Kernel", "Size", "", "", "Old GB/s", "New GB/s", "Change" );
+
+        for( int iNew = 0; iNew < nNew; iNew++ )
+        {
+            const BenchResult *now = &aNew[ iNew ];
+            const BenchResult *was = NULL;
+            for( int iOld = 0; !was && (iOld < nOld); iOld++ )
+                if (!strcmp( aOld[ iOld ].kernel, now->kernel )
+                && (aOld[ iOld ].size      == now->size     )
+                && (aOld[ iOld ].cache     == now->cache    )
+                && (aOld[ iOld ].unaligned == now->unaligned))
+                    was = &aOld[ iOld ];
+
+            if (!was || (was->gbps <= 0.))
+                continue;
+
+            const double change = 100. * (now->gbps - was->gbps) / was->gbps;
+            const bool   bSlow  = change < -threshold;
+
+            printf( "%-24s  %10llu  %-6s  %-9s  %10.3f  %10.3f  %+7.1f%%%s\n"
+                , now->kernel
+                , (unsigned long long) now->size
+                , gaCacheName[ now->cache ]
+                , now->unaligned ? "unaligned" : "aligned"
+                , was->gbps
+                , now->gbps
+                , change
+                , bSlow ? "  REGRESSION" : ""
+            );
+
+            nMatch++;
+            nRegress += bSlow;
+        }
+
+        printf( "\n%d of %d results matched, %d slower by more than %.1f%%\n", nMatch, nNew, nRegress, threshold );
+        return nRegress ? 1 : 0;
+    }
+
+// ========================================================================
+int Usage()
+{
+    printf(
+"Benchmark CRC32 kernels\n"
+"https://github.com/Michaelangel007/crc32\n"
+"\n"
+"Usage: bench [options]\n"
+"       bench -C<baseline.json> [-T#] current.json\n"
+"    -?          Display usage\n"
+"    -c          Also measure with a cold cache\n"
+"    -e          Also count cycles, instructions, L1D and branch misses (Linux)\n"
+"    -H          Show per call latency histograms, needs -DUSE_LATENCY=1\n"
+"    -k<name>    Only kernels whose name contains name\n"
+"    -l<size>    Largest buffer, suffix K M G (default 64M)\n"
+"    -o<file>    Also write results as JSON\n"
+"    -p[size]    Also measure sharing L1 with a working set (default 32K)\n"
+"    -s<size>    Smallest buffer (default 16)\n"
+"    -t#         Timed trials per measurement (default 31)\n"
+"    -u          Also measure unaligned input\n"
+"    -w#         Warmup trials (default 3)\n"
+"    -C<base>    Compare JSON results of baseline against file, see -T\n"
+"    -T#         Percent slower that counts as a regression (default 5)\n"
+"\n"
+"Buffer sizes are powers of 4 from smallest to largest.\n"
+"\n"
+"Examples:\n"
+"\n"
+"    ./bench -kreverse\n"
+"    ./bench -c -u -s4K -l1G\n"
+"    ./bench -onew.json && ./bench -Cold.json -T10 new.json\n"
+    );
+
+    return 0;
+}
+
+// ========================================================================
+int main(int nArg, char *aArg[])
+{
+    Profile_Init();
+    PROFILE_SCOPE( "bench" );
+
+    {
+        PROFILE_SCOPE( "table init" );
+        common_init( false );
+    }
+
+    const char *pBaseline = NULL;  // -C
+    const char *pCurrent  = NULL;
+    double      threshold = 5.0;   // -T
+
+    for( int iArg = 1; iArg < nArg; iArg++ )
+    {
+        char *pArg = aArg[ iArg ];
+        if (pArg[0] == '-')
+        {
+            pArg++; // point to 1st char in option
+
+            if (*pArg == '?') return Usage();
+            if (*pArg == 'c')
+                gbCold = true;
+            else
+            if (*pArg == 'C')
+                pBaseline = pArg+1;
+            else
+            if (*pArg == 'T')
+                threshold = atof( pArg+1 );
+            else
+            if (*pArg == 'e')
+                gbPerf = true;
+            else
+            if (*pArg == 'H')
+                gbLatency = true;
+            else
+            if (*pArg == 'k')
+                gpFilter = pArg+1;
+            else
+            if (*pArg == 'l')
+                gnMaxSize = Bench_ParseSize( pArg+1 );
+            else
+            if (*pArg == 'o')
+                gpJsonFile = pArg+1;
+            else
+            if (*pArg == 'p')
+            {
+                gbShared = true;
+                if (pArg[1])
+                    gnShared = Bench_ParseSize( pArg+1 );
+            }
+            else
+            if (*pArg == 's')
+                gnMinSize = Bench_ParseSize( pArg+1 );
+            else
+            if (*pArg == 't')
+                gnTrials = atoi( pArg+1 );
+            else
+            if (*pArg == 'u')
+                gbUnalign = true;
+            else
+            if (*pArg == 'w')
+                gnWarmup = atoi( pArg+1 );
+            else
+                printf( "Unrecognized option: %c\n", *pArg );
+        }
+        else
+        if (pBaseline && !pCurrent)
+            pCurrent = pArg;
+        else
+            return Usage();
+    }
+
+    if (pBaseline)
+        return pCurrent ? Results_Compare( pBaseline, pCurrent, threshold ) : Usage();
+
+    if (!gnMinSize || (gnMinSize > gnMaxSize))
+    {
+        printf( "ERROR: Smallest buffer must be 1 .. largest\n" );
+        return 1;
+    }
+
+    // Self-check every kernel before timing it
+    const int       nCheck = (int) strlen( CRC32_CHECK_TXT );
+    const Crc32Kernel *aRun[ MAX_KERNELS ];
+    int             nRun   = 0;
+
+    for( int iKernel = 0; iKernel < nKernels; iKernel++ )
+    {
+        const Crc32Kernel *kernel = &aKernels[ iKernel ];
+        if (gpFilter && !strstr( kernel->name, gpFilter ))
+            continue;
+
+        PROFILE_SCOPE( "self check" );
+
+        const uint32_t crc = kernel->func( nCheck, (const unsigned char*) CRC32_CHECK_TXT );
+        if (crc != kernel->check)
+            printf( "ERROR: %s( \"%s\" ) = 0x%08X, expected 0x%08X\n", kernel->name, CRC32_CHECK_TXT, crc, kernel->check );
+        else
+            aRun[ nRun++ ] = kernel;
+    }
+
+    if (!nRun)
+    {
+        printf( "No kernels to run\n" );
+        return 1;
+    }
+
+    // 64 byte aligned, +1 for unaligned
+    unsigned char *pAlloc  = (unsigned char*) malloc( gnMaxSize + 64 + 1 );
+    if (!pAlloc)
+    {
+        printf( "ERROR: Couldn't allocate %llu bytes, try a smaller -l\n", (unsigned long long) gnMaxSize );
+        return 1;
+    }
+    unsigned char *pBuffer = (unsigned char*)(((uintptr_t) pAlloc + 63) & ~(uintptr_t)63);
+
+    uint32_t seed = 0x12345678;
+    for( size_t offset = 0; offset < gnMaxSize + 1; offset++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        pBuffer[ offset ] = (unsigned char)(seed >> 16);
+    }
+
+    if (gbCold)
+        gpCold = (unsigned char*) calloc( COLD_SIZE, 1 );
+    if (gbShared)
+        gpShared = (unsigned char*) calloc( gnShared + 1, 1 );
+
+    char brand[ 64 ];
+    Cpu_Brand( brand );
+
+    if (gpJsonFile)
+    {
+        gpJson = fopen( gpJsonFile, "w" );
+        if (!gpJson)
+        {
+            printf( "ERROR: Couldn't write '%s'\n", gpJsonFile );
+            return 1;
+        }
+        fprintf( gpJson, "{ \"cpu\": \"%s\", \"trials\": %d, \"results\": [\n", brand, gnTrials );
+    }
+
+    printf( "CPU: %s, %s%s%s%s\n"
+        , brand
+        , Cpu_HasSSSE3 () ? "SSSE3 "  : ""
+        , Cpu_HasSSE42 () ? "SSE4.2 " : ""
+        , Cpu_HasPCLMUL() ? "PCLMUL " : ""
+        , Cpu_HasAVX2  () ? "AVX2"    : ""
+    );
+    if (gbPerf && !Perf_Open( &gPerf ))
+        printf( "WARNING: No hardware perf counters: %s\n", gPerf.error ? strerror( gPerf.error ) : "not Linux" );
+
+    printf( "%d trials after %d warmup, median GB/s and cycles/byte, min / median / p99 per call\n\n", gnTrials, gnWarmup );
+
+    for( int iRun = 0; iRun < nRun; iRun++ )
+    {
+        PROFILE_SCOPE( aRun[ iRun ]->name );
+        for( size_t size = gnMinSize; size <= gnMaxSize; size *= 4 )
+            for( int bUnalign = 0; bUnalign <= (int) gbUnalign; bUnalign++ )
+                for( int cache = 0; cache < NUM_CACHE; cache++ )
+                    if ((cache == CACHE_WARM) || ((cache == CACHE_COLD) && gbCold) || ((cache == CACHE_SHARED) && gbShared))
+                        Bench_Run( aRun[ iRun ], pBuffer + bUnalign, size, cache, bUnalign != 0 );
+        printf( "\n" );
+    }
+
+    if (gpJson)
+    {
+        fprintf( gpJson, "] }\n" );
+        fclose( gpJson );
+        printf( "Wrote %d results to '%s'\n", gnJson, gpJsonFile );
+    }
+
+    if (gbLatency)
+        Latency_Dump();
+
+    if (gbPerf)
+        Perf_Close( &gPerf );
+    free( gpCold );
+    free( gpShared );
+    free( pAlloc );
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Character sets for constrained searches using hashcat style classes:
+
+    l  abcdefghijklmnopqrstuvwxyz
+    u  ABCDEFGHIJKLMNOPQRSTUVWXYZ
+    d  0123456789
+    h  0123456789abcdef
+    H  0123456789ABCDEF
+    s   !"#$%&'()*+,-./:;<=>?@[\]^_`{|}~
+    a  ?l?u?d?s  (printable ASCII)
+    b  0x00 .. 0xFF
+
+*/
+
+// Types
+
+    struct Charset
+    {
+        uint8_t chars[ 256 ]; // in the order added
+        int     count;
+        bool    has  [ 256 ];
+    };
+
+// Implementation
+
+    // ========================================================================
+    void Charset_Clear( Charset *set )
+    {
+        memset( set, 0, sizeof( *set ) );
+    }
+
+    // ========================================================================
+    void Charset_AddRange( Charset *set, const int first, const int last )
+    {
+        for( int c = first; c <= last; c++ )
+            if (!set->has[ c ])
+            {
+                set->has  [ c ] = true;
+                set->chars[ set->count++ ] = (uint8_t) c;
+            }
+    }
+
+    // @return false if class is unknown
+    // ========================================================================
+    bool Charset_AddClass( Charset *set, const char klass )
+    {
+        switch( klass )
+        {
+            case 'l': Charset_AddRange( set, 'a', 'z' ); break;
+            case 'u': Charset_AddRange( set, 'A', 'Z' ); break;
+            case 'd': Charset_AddRange( set, '0', '9' ); break;
+            case 'h': Charset_AddRange( set, '0', '9' ); Charset_AddRange( set, 'a', 'f' ); break;
+            case 'H': Charset_AddRange( set, '0', '9' ); Charset_AddRange( set, 'A', 'F' ); break;
+            case 's': Charset_AddRange( set, 0x20, 0x2F ); Charset_AddRange( set, 0x3A, 0x40 );
+                      Charset_AddRange( set, 0x5B, 0x60 ); Charset_AddRange( set, 0x7B, 0x7E ); break;
+            case 'a': Charset_AddRange( set, 0x20, 0x7E ); break;
+            case 'b': Charset_AddRange( set, 0x00, 0xFF ); break;
+            default : return false;
+        }
+        return true;
+    }
+
+    // Union of classes, i.e. "lud" = alphanumeric
+    // @return false if any class is unknown
+    // ========================================================================
+    bool Charset_Parse( Charset *set, const char *classes )
+    {
+        Charset_Clear( set );
+        for( ; *classes; classes++ )
+        {
+            if (*classes == '?')
+                continue;
+            if (!Charset_AddClass( set, *classes ))
+                return false;
+        }
+        return set->count > 0;
+    }
+
+// Masks
+
+    // Hashcat style mask, i.e. "?l?l?d?d?u" or with a fixed template "id_?d?d?d"
+    //     ?<class>  one char from the class
+    //     ??        literal '?'
+    //     other     literal char
+    const int MAX_MASK = 64;
+
+    struct Mask
+    {
+        Charset pos[ MAX_MASK ];
+        int     length;
+    };
+
+    // @return false if the mask is too long or has an unknown class
+    // ========================================================================
+    bool Mask_Parse( Mask *mask, const char *text )
+    {
+        mask->length = 0;
+        for( ; *text; text++ )
+        {
+            if (mask->length >= MAX_MASK)
+                return false;
+
+            Charset *set = &mask->pos[ mask->length++ ];
+            Charset_Clear( set );
+
+            if ((text[0] == '?') && (text[1] == '?'))
+            {
+                Charset_AddRange( set, '?', '?' );
+                text++;
+            }
+            else
+            if (text[0] == '?')
+            {
+                if (!Charset_AddClass( set, text[1] ))
+                    return false;
+                text++;
+            }
+            else
+                Charset_AddRange( set, (uint8_t) text[0], (uint8_t) text[0] );
+        }
+        return true;
+    }
@@ -4,7 +4,7 @@
 
 // Vars
 
-    uint32_t REVERSE_BITS[ 256 ];
+    uint8_t  REVERSE_BITS[ 256 ];
 
 // ========================================================================
 void common_init( const int bDumpTables = false )
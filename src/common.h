@@ -5,6 +5,8 @@
     #include <stdlib.h> // atoi()
 
 // User
+    #include "util_cpu.h"
     #include "reverse.h"
+    #include "util_latency.h"
     #include "crc32.h"
     #include "compare.h"
@@ -98,3 +98,18 @@ Copyleft (C) 2017
         }
         printf( "\n" );
     }
+
+    // Dump 8-bit table of 256 entries
+    // ========================================================================
+    void dump( const char *header, const uint8_t *table )
+    {
+        printf( "%s\n", header );
+
+        for (int i = 0; i < 256; i++ )
+        {
+            printf( "%02X, ", table[ i ] );
+            if ((i % 16) == 15)
+                printf( " // %3d [0x%02X .. 0x%02X]\n", i-15,i-15, i );
+        }
+        printf( "\n" );
+    }
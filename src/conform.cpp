@@ -0,0 +1,777 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Randomized differential conformance test of every kernel in
+crc32_kernels.h against its formula reference.
+
+First the fixed checks:
+
+  * every kernel's check value of "123456789"
+  * every CRC32Id form against CRC32Family[], and the fused engine
+  * crc32c_u32(), crc32c_u64(), and crc32c_fixed<N>(), SSE 4.2 and
+    slicing, against crc32c_reverse()
+  * every aData[] x aFunc[] form rewritten by crc32_rewrite.h
+  * "..."_crc32 and _crc32c compile time CRCs as case labels
+  * every crc_width.h model, table and PCLMUL, against its formula on
+    random lengths 0 .. 4 KB, fed whole and in two pieces
+
+Then each random case picks a length, an alignment 0..63, random data,
+and up to 3 split points. Every kernel is compared against its reference,
+and kernels with a stream function are also fed the data in pieces.
+
+The formula references cost about 10 ns/byte each, so lengths are mostly
+short, where the head/tail handling of wide kernels goes wrong, with a
+few up to -l bytes. Case i only depends on the seed and i, so any case
+can be rerun alone with -s and -i, on any # of threads.
+
+A failing input is minimized before it is reported: the tail and head are
+cut in halves, then chunks down to single bytes are removed, and bytes
+are zeroed while it still fails.
+
+*/
+
+// Defines
+#define USE_OMP 1
+#if _WIN32
+    #define _CRT_SECURE_NO_WARNINGS 1
+#endif
+#ifndef USE_ZLIB
+    #define USE_ZLIB 1
+#endif
+
+// Includes
+    #include "common.cpp"
+
+// BEGIN OMP
+#if USE_OMP
+    #include <omp.h>
+#endif
+    #include "util_threads.h"
+    #include "util_timer.h"
+// END OMP
+#if USE_ZLIB
+    #include <zlib.h>
+#endif
+    #include "crc32_kernels.h"
+    #include "crc32_rewrite.h"
+    #include "crc32_models.h"
+    #include "util_tune.h"
+    #include "crc_width.h"
+
+// Consts
+    const int    MAX_SPLITS   = 3;
+    const size_t MAX_ALIGN    = 64;
+    const int    MAX_MINIMIZE = 100000; // kernel calls per failure
+    const int    MAX_DUMP     = 64;     // bytes of a minimized input shown
+
+// Types
+    struct Case
+    {
+        uint64_t index ;
+        size_t   length;
+        size_t   align ;
+        int      nSplit;
+        size_t   aSplit[ MAX_SPLITS ]; // ascending, <= length
+    };
+
+    // Kernels share a few references, each is computed once per case
+    struct ReferenceCache
+    {
+        int       nEntry;
+        Crc32Func aFunc[ 8 ];
+        uint32_t  aCRC [ 8 ];
+    };
+
+// Vars
+    const char *gpFilter  = NULL;      // -k
+    uint64_t    gnCases   = 1000000;   // -n
+    size_t      gnMaxSize = 4 << 20;   // -l
+    uint64_t    gnSeed    = 1;         // -s
+    int64_t     giCase    = -1;        // -i, run only this case
+    bool        gbVerbose = false;     // -v
+
+    bool        gaActive  [ nKernels ];
+    uint64_t    gaFailures[ nKernels ];
+    bool        gaReported[ nKernels ]; // first failure of each kernel is minimized
+
+// Random
+
+    // splitmix64, so case i can be generated without cases 0 .. i-1
+    // ========================================================================
+    inline uint64_t Random_Next( uint64_t *state )
+    {
+        uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // ========================================================================
+    void Random_Fill( uint64_t *state, unsigned char *buffer, size_t length )
+    {
+        while( length >= 8 )
+        {
+            const uint64_t r = Random_Next( state );
+            memcpy( buffer, &r, 8 );
+            buffer += 8;
+            length -= 8;
+        }
+        const uint64_t r = Random_Next( state );
+        memcpy( buffer, &r, length );
+    }
+
+    // 15/16 up to 64 bytes, 1/16 up to 4 KB, 1/1024 up to 64 KB, 1/65536 up to gnMaxSize
+    // ========================================================================
+    size_t Random_Length( uint64_t *state )
+    {
+        const uint64_t r     = Random_Next( state );
+        const uint64_t shape = r & 0xFFFF;
+        size_t         limit = 64;
+
+        if (shape == 0)
+            limit = gnMaxSize;
+        else
+        if ((shape & 0x3FF) == 0)
+            limit = 64 << 10;
+        else
+        if ((shape & 0xF) == 0)
+            limit = 4 << 10;
+
+        if (limit > gnMaxSize)
+            limit = gnMaxSize;
+
+        // Uniform in log2 so every power of two range is hit
+        const int bits = (int)((r >> 16) % 24);
+        size_t    span = (size_t)1 << bits;
+        if (span > limit)
+            span = limit;
+        return (size_t)((r >> 34) % (span + 1));
+    }
+
+    // ========================================================================
+    void Case_Make( Case *test, const uint64_t index, unsigned char *buffer )
+    {
+        uint64_t state = gnSeed * 0xD1B54A32D192ED03ull + index;
+
+        test->index  = index;
+        test->length = Random_Length( &state );
+        test->align  = Random_Next( &state ) % MAX_ALIGN;
+        test->nSplit = (int)(Random_Next( &state ) % (MAX_SPLITS + 1));
+
+        for( int iSplit = 0; iSplit < test->nSplit; iSplit++ )
+            test->aSplit[ iSplit ] = Random_Next( &state ) % (test->length + 1);
+
+        // Insertion sort, at most 3
+        for( int i = 1; i < test->nSplit; i++ )
+            for( int j = i; (j > 0) && (test->aSplit[ j-1 ] > test->aSplit[ j ]); j-- )
+            {
+                const size_t t = test->aSplit[ j ]; test->aSplit[ j ] = test->aSplit[ j-1 ]; test->aSplit[ j-1 ] = t;
+            }
+
+        Random_Fill( &state, buffer + test->align, test->length );
+    }
+
+// Implementation
+
+    // Feeds data to stream in pieces at the split points, clamped to length
+    // ========================================================================
+    uint32_t Stream_Split( Crc32Stream stream, const unsigned char *data, const size_t length, const int nSplit, const size_t *aSplit )
+    {
+        uint32_t crc  = 0;
+        size_t   done = 0;
+
+        for( int iSplit = 0; iSplit < nSplit; iSplit++ )
+        {
+            const size_t split = (aSplit[ iSplit ] < length) ? aSplit[ iSplit ] : length;
+            if (split < done)
+                continue;
+            crc  = stream( crc, split - done, data + done );
+            done = split;
+        }
+        return stream( crc, length - done, data + done );
+    }
+
+    // ========================================================================
+    uint32_t Reference( ReferenceCache *cache, Crc32Func reference, const unsigned char *data, const size_t length )
+    {
+        if (!cache)
+            return reference( length, data );
+
+        for( int iEntry = 0; iEntry < cache->nEntry; iEntry++ )
+            if (cache->aFunc[ iEntry ] == reference)
+                return cache->aCRC[ iEntry ];
+
+        const uint32_t crc = reference( length, data );
+        if (cache->nEntry < 8)
+        {
+            cache->aFunc[ cache->nEntry ] = reference;
+            cache->aCRC [ cache->nEntry ] = crc;
+            cache->nEntry++;
+        }
+        return crc;
+    }
+
+    // @param cache - NULL while minimizing, the data changes between calls
+    // @return true if the kernel disagrees with its reference
+    // ========================================================================
+    bool Kernel_Fails( const Crc32Kernel *kernel, const unsigned char *data, const size_t length, const int nSplit, const size_t *aSplit, ReferenceCache *cache = NULL )
+    {
+        const uint32_t expect = Reference( cache, kernel->reference, data, length );
+
+        if (kernel->func( length, data ) != expect)
+            return true;
+
+        return kernel->stream && (Stream_Split( kernel->stream, data, length, nSplit, aSplit ) != expect);
+    }
+
+    // Shrinks data in place while the kernel still fails
+    // @return minimized length
+    // ========================================================================
+    size_t Minimize( const Crc32Kernel *kernel, unsigned char *data, size_t length, const int nSplit, const size_t *aSplit )
+    {
+        int nCalls = 0;
+
+        // Cut the tail in halves
+        while( (length > 0) && (nCalls++ < MAX_MINIMIZE) && Kernel_Fails( kernel, data, length/2, nSplit, aSplit ) )
+            length /= 2;
+
+        // Remove chunks, halving the chunk size down to 1 byte
+        for( size_t chunk = (length + 1) / 2; chunk > 0; chunk /= 2 )
+        {
+            for( size_t offset = 0; (offset + chunk <= length) && (nCalls < MAX_MINIMIZE); )
+            {
+                static unsigned char removed[ 1 << 16 ]; // per failure, under critical
+                if (chunk > sizeof( removed ))
+                    break;
+
+                memcpy ( removed, data + offset, chunk );
+                memmove( data + offset, data + offset + chunk, length - offset - chunk );
+
+                nCalls++;
+                if (Kernel_Fails( kernel, data, length - chunk, nSplit, aSplit ))
+                    length -= chunk;
+                else
+                {
+                    memmove( data + offset + chunk, data + offset, length - offset - chunk );
+                    memcpy ( data + offset, removed, chunk );
+                    offset += chunk;
+                }
+            }
+        }
+
+        // Simplest byte values
+        for( size_t offset = 0; (offset < length) && (nCalls < MAX_MINIMIZE); offset++ )
+        {
+            const unsigned char was = data[ offset ];
+            if (!was)
+                continue;
+
+            data[ offset ] = 0;
+            nCalls++;
+            if (!Kernel_Fails( kernel, data, length, nSplit, aSplit ))
+                data[ offset ] = was;
+        }
+
+        return length;
+    }
+
+    // ========================================================================
+    void Report( const Crc32Kernel *kernel, const Case *test, const unsigned char *data )
+    {
+        unsigned char *copy = (unsigned char*) malloc( test->length + 1 );
+        memcpy( copy, data, test->length );
+
+        const size_t   length = Minimize( kernel, copy, test->length, test->nSplit, test->aSplit );
+        const uint32_t expect = kernel->reference( length, copy );
+        const uint32_t actual = kernel->func     ( length, copy );
+
+        printf( "FAIL: %s case %llu, length %llu, align %u, splits %d\n"
+            , kernel->name
+            , (unsigned long long) test->index
+            , (unsigned long long) test->length
+            , (unsigned) test->align
+            , test->nSplit
+        );
+        printf( "    minimized to %llu bytes: expected 0x%08X, func 0x%08X", (unsigned long long) length, expect, actual );
+        if (kernel->stream)
+            printf( ", stream 0x%08X", Stream_Split( kernel->stream, copy, length, test->nSplit, test->aSplit ) );
+        printf( "\n    data:" );
+
+        for( size_t offset = 0; (offset < length) && (offset < (size_t) MAX_DUMP); offset++ )
+            printf( " %02X", copy[ offset ] );
+        printf( "%s\n", (length > (size_t) MAX_DUMP) ? " ..." : "" );
+
+        free( copy );
+    }
+
+    // @return number of fixed checks that failed
+    // reverse32/64() and the REVERSE_BITS table against the reflect32() formula
+    // ========================================================================
+    int Check_Reverse()
+    {
+        int nBad = 0;
+
+        uint64_t state = 0;
+        for( int iBit = 0; iBit < 64; iBit++ )
+        {
+            const uint64_t x = Random_Next( &state ) | (1ull << iBit);
+            const uint64_t r = ((uint64_t) reflect32( (uint32_t) x ) << 32) | reflect32( (uint32_t)(x >> 32) );
+            if ((reverse32( (uint32_t) x ) != (uint32_t)(r >> 32)) || (reverse64( x ) != r))
+            {
+                printf( "FAIL: reverse32/64( 0x%016llX )\n", (unsigned long long) x );
+                nBad++;
+            }
+        }
+
+        for( int byte = 0; byte < 256; byte++ )
+            if (REVERSE_BITS[ byte ] != (reflect32( byte ) >> 24))
+            {
+                printf( "FAIL: REVERSE_BITS[ 0x%02X ]\n", byte );
+                nBad++;
+            }
+
+        return nBad;
+    }
+
+    // @return 1 if crc32c_fixed<N>() doesn't match crc32c_reverse()
+    // ========================================================================
+    template<size_t N>
+    int Check_Crc32cFixed( const unsigned char *key )
+    {
+        const uint32_t expect = crc32c_reverse( N, key );
+        const uint32_t crc    = crc32c_fixed<N>( key );
+        if (crc == expect)
+            return 0;
+
+        printf( "FAIL: crc32c_fixed<%d> 0x%08X != 0x%08X, %s\n", (int) N, crc, expect, gbCrc32cHw ? "SSE 4.2" : "slicing" );
+        return 1;
+    }
+
+    // @return number of fixed checks that failed
+    // Fixed length CRC32C, with and without SSE 4.2, against crc32c_reverse()
+    // ========================================================================
+    int Check_Crc32cKeys()
+    {
+        const bool bHw   = gbCrc32cHw;
+        int        nBad  = 0;
+        uint64_t   state = 0;
+
+        for( int iPath = bHw ? 0 : 1; iPath < 2; iPath++ )
+        {
+            gbCrc32cHw = !iPath;
+            for( int iCase = 0; iCase < 64; iCase++ )
+            {
+                unsigned char key[ 64 + 1 ];
+                Random_Fill( &state, key, sizeof( key ) );
+                const unsigned char *data = key + (iCase & 1); // unaligned
+
+                uint64_t u64 = 0;
+                for( int byte = 7; byte >= 0; byte-- )
+                    u64 = (u64 << 8) | data[ byte ];
+                const uint32_t u32 = (uint32_t) u64;
+
+                if ((crc32c_u32( u32 ) != crc32c_reverse( 4, data ))
+                ||  (crc32c_u64( u64 ) != crc32c_reverse( 8, data )))
+                {
+                    printf( "FAIL: crc32c_u32/u64( 0x%016llX ), %s\n", (unsigned long long) u64, gbCrc32cHw ? "SSE 4.2" : "slicing" );
+                    nBad++;
+                }
+
+                nBad += Check_Crc32cFixed< 1>( data );
+                nBad += Check_Crc32cFixed< 3>( data );
+                nBad += Check_Crc32cFixed< 4>( data );
+                nBad += Check_Crc32cFixed< 7>( data );
+                nBad += Check_Crc32cFixed< 8>( data );
+                nBad += Check_Crc32cFixed<12>( data );
+                nBad += Check_Crc32cFixed<15>( data );
+                nBad += Check_Crc32cFixed<16>( data );
+                nBad += Check_Crc32cFixed<32>( data );
+                nBad += Check_Crc32cFixed<63>( data );
+                nBad += Check_Crc32cFixed<64>( data );
+            }
+        }
+
+        gbCrc32cHw = bHw;
+        return nBad;
+    }
+
+    // @return number of fixed checks that failed
+    // Every table x form, and CRC32C, rewritten against aFunc[]
+    // ========================================================================
+    int Check_Rewrite()
+    {
+        static Crc32Rewrite  rewrite;
+        static unsigned char buffer[ 1024 + 64 ];
+        int                  nBad  = 0;
+        uint64_t             state = 0;
+
+        Random_Fill( &state, buffer, sizeof( buffer ) );
+
+        for( int id = 0; id < 32 + 8; id++ )
+        {
+            const uint32_t *table = (id < 32) ? aData[ id >> 3 ] : CRC32C_REVERSED;
+            const int       form  = id & 7;
+            Crc32Rewrite_Init( &rewrite, table, form );
+
+            for( int iCase = 0; iCase < 64; iCase++ )
+            {
+                const size_t         length = (size_t)(Random_Next( &state ) % 1025);
+                const unsigned char *data   = buffer + (Random_Next( &state ) % 64);
+
+                const uint32_t expect = aFunc[ form ]( table, length, data );
+                const uint32_t crc    = Crc32Rewrite_Crc( &rewrite, length, data );
+                if (crc != expect)
+                {
+                    printf( "FAIL: rewrite of %s %d, %s, length %d, 0x%08X != 0x%08X\n"
+                        , (id < 32) ? "CRC32Id" : "CRC32C form", (id < 32) ? id : form, gaRewriteKernel[ rewrite.kernel ], (int) length, crc, expect );
+                    nBad++;
+                    break;
+                }
+            }
+        }
+
+        return nBad;
+    }
+
+    // @return number of fixed checks that failed
+    // Compile time CRCs as case labels against the runtime kernels
+    // ========================================================================
+    int Check_Constexpr()
+    {
+        const char *aName[] = { "open", "close", "read", "write" };
+        const int   nName   = sizeof( aName ) / sizeof( aName[0] );
+        int         nBad    = 0;
+
+        for( int iName = 0; iName < nName; iName++ )
+        {
+            const char          *name   = aName[ iName ];
+            const size_t         length = strlen( name );
+            const unsigned char *data   = (const unsigned char*) name;
+            int                  crc32  = -1, crc32c = -1;
+
+            switch( crc32_reverse( length, data ) )
+            {
+                case "open"_crc32 : crc32 = 0; break;
+                case "close"_crc32: crc32 = 1; break;
+                case "read"_crc32 : crc32 = 2; break;
+                case "write"_crc32: crc32 = 3; break;
+            }
+
+            switch( ~crc32c_update( ~0u, length, data ) )
+            {
+                case "open"_crc32c : crc32c = 0; break;
+                case "close"_crc32c: crc32c = 1; break;
+                case "read"_crc32c : crc32c = 2; break;
+                case "write"_crc32c: crc32c = 3; break;
+            }
+
+            if ((crc32 != iName) || (crc32c != iName))
+            {
+                printf( "FAIL: \"%s\"_crc32 / _crc32c doesn't match crc32_reverse / crc32c_update\n", name );
+                nBad++;
+            }
+        }
+
+        return nBad;
+    }
+
+    // ========================================================================
+    template<typename C>
+    int Check_Width( const CrcModel<C> *aModel, const int nModel )
+    {
+        static CrcTable<C>   table;
+        static unsigned char buffer[ 4096 + 64 ];
+        int                  nBad  = 0;
+        uint64_t             state = 0;
+
+        Random_Fill( &state, buffer, sizeof( buffer ) );
+
+        for( int iModel = 0; iModel < nModel; iModel++ )
+        {
+            const CrcModel<C> *model = &aModel[ iModel ];
+            if (!Crc_Init( &table, model ))
+            {
+                printf( "FAIL: %s check doesn't match\n", model->name );
+                nBad++;
+                continue;
+            }
+
+            for( int iCase = 0; iCase < 256; iCase++ )
+            {
+                const size_t         length = (size_t)(Random_Next( &state ) % 4097);
+                const size_t         split  = (size_t)(Random_Next( &state ) % (length + 1));
+                const unsigned char *data   = buffer + (Random_Next( &state ) % 64);
+
+                const C expect = Crc_Formula( model, length, data );
+                const C whole  = Crc_Compute( &table, length, data );
+                const C pieces = Crc_End( &table, Crc_Update( &table, Crc_Update( &table, Crc_Begin( &table ), split, data ), length - split, data + split ) );
+
+                if ((whole != expect) || (pieces != expect))
+                {
+                    printf( "FAIL: %s length %d split %d, 0x%llX / 0x%llX != 0x%llX\n"
+                        , model->name, (int) length, (int) split
+                        , (unsigned long long) whole, (unsigned long long) pieces, (unsigned long long) expect );
+                    nBad++;
+                    break;
+                }
+            }
+        }
+
+        return nBad;
+    }
+
+    // ========================================================================
+    int Check_Fixed()
+    {
+        const size_t         length = strlen( CRC32_CHECK_TXT );
+        const unsigned char *text   = (const unsigned char*) CRC32_CHECK_TXT;
+        int                  nBad   = 0;
+
+        for( int iKernel = 0; iKernel < nKernels; iKernel++ )
+        {
+            const Crc32Kernel *kernel = &aKernels[ iKernel ];
+            if (!gaActive[ iKernel ])
+                continue;
+
+            const uint32_t crc = kernel->func( length, text );
+            if (crc != kernel->check)
+            {
+                printf( "FAIL: %s check 0x%08X != 0x%08X\n", kernel->name, crc, kernel->check );
+                nBad++;
+            }
+
+            if (kernel->reference( length, text ) != kernel->check)
+            {
+                printf( "FAIL: %s reference check doesn't match\n", kernel->name );
+                nBad++;
+            }
+
+            if (kernel->stream && (kernel->stream( kernel->stream( 0, 4, text ), length - 4, text + 4 ) != kernel->check))
+            {
+                printf( "FAIL: %s stream check doesn't match\n", kernel->name );
+                nBad++;
+            }
+        }
+
+        for( int id = 0; id < 32; id++ )
+        {
+            const uint32_t crc = aFunc[ id & 7 ]( aData[ id >> 3 ], length, text );
+            if (crc != CRC32Family[ id ])
+            {
+                printf( "FAIL: CRC32Id %d check 0x%08X != 0x%08X\n", id, crc, CRC32Family[ id ] );
+                nBad++;
+            }
+        }
+
+        nBad += Check_Reverse();
+        nBad += Check_Crc32cKeys();
+        nBad += Check_Rewrite();
+        nBad += Check_Constexpr();
+        nBad += Check_Width( aCrc8Models , nCrc8Models  );
+        nBad += Check_Width( aCrc16Models, nCrc16Models );
+        nBad += Check_Width( aCrc32Models, nCrc32Models );
+        nBad += Check_Width( aCrc64Models, nCrc64Models );
+        nBad += Crc32Models_Init();
+        return nBad;
+    }
+
+// ========================================================================
+int Usage()
+{
+    printf(
+"Differential conformance test of every CRC32 kernel against its formula reference\n"
+"\n"
+"Usage: conform [options]\n"
+"\n"
+"    -i#         Only run case #, i.e. one reported by a failure\n"
+#if USE_OMP
+"    -j#         Use # threads (default all)\n"
+#endif
+"    -k<name>    Only test kernels whose name contains <name>\n"
+"    -l<size>    Largest length, suffix K M (default 4M)\n"
+"    -n#         Number of random cases (default 1000000)\n"
+"    -s#         Random seed (default 1)\n"
+"    -v          Show per kernel totals\n"
+"\n"
+"Exits with 1 if any kernel fails.\n"
+"\n"
+"Examples:\n"
+"    ./conform -n10000000\n"
+"    ./conform -kzlib -l64M -n1000\n"
+"    ./conform -s7 -i123456\n"
+    );
+    return 0;
+}
+
+// ========================================================================
+int main( const int nArg, const char *aArg[] )
+{
+    common_init( false );
+    Tune_Load();
+
+#if USE_OMP
+    Threads_Default();
+    gnThreadsActive = gTune.threads; // -j overrides
+#endif // USE_OMP
+
+    for( int iArg = 1; iArg < nArg; iArg++ )
+    {
+        const char *pArg = aArg[ iArg ];
+        if (pArg[0] == '-')
+        {
+            pArg++;
+
+            if (*pArg == '?')
+                return Usage();
+            else
+            if (*pArg == 'i')
+                giCase = (int64_t) strtoull( pArg+1, NULL, 10 );
+            else
+#if USE_OMP
+            if (*pArg == 'j')
+            {
+                int i = atoi( pArg+1 );
+                if( i > 0 )
+                    gnThreadsActive = i;
+                if( gnThreadsActive > MAX_THREADS )
+                    gnThreadsActive = MAX_THREADS;
+            }
+            else
+#endif // USE_OMP
+            if (*pArg == 'k')
+                gpFilter = pArg+1;
+            else
+            if (*pArg == 'l')
+            {
+                char *unit;
+                gnMaxSize = (size_t) strtoull( pArg+1, &unit, 10 );
+                if ((*unit == 'k') || (*unit == 'K')) gnMaxSize <<= 10;
+                if ((*unit == 'm') || (*unit == 'M')) gnMaxSize <<= 20;
+            }
+            else
+            if (*pArg == 'n')
+                gnCases = strtoull( pArg+1, NULL, 10 );
+            else
+            if (*pArg == 's')
+                gnSeed = strtoull( pArg+1, NULL, 10 );
+            else
+            if (*pArg == 'v')
+                gbVerbose = true;
+            else
+                return Usage();
+        }
+        else
+            return Usage();
+    }
+
+#if USE_OMP
+    Threads_Set();
+#endif // USE_OMP
+
+    int nActive = 0;
+    for( int iKernel = 0; iKernel < nKernels; iKernel++ )
+    {
+        gaActive[ iKernel ] = !gpFilter || strstr( aKernels[ iKernel ].name, gpFilter );
+        nActive += gaActive[ iKernel ];
+    }
+
+    int nBad = Check_Fixed();
+    printf( "Fixed checks: %s\n", nBad ? "FAILED" : "OK" );
+
+    uint64_t nFirst = 0;
+    uint64_t nLast  = gnCases;
+    if (giCase >= 0)
+    {
+        nFirst = (uint64_t) giCase;
+        nLast  = nFirst + 1;
+    }
+
+    printf( "Testing %d kernels, %llu cases, lengths 0 .. %llu, seed %llu, %d threads\n"
+        , nActive
+        , (unsigned long long)(nLast - nFirst)
+        , (unsigned long long) gnMaxSize
+        , (unsigned long long) gnSeed
+        , gnThreadsActive
+    );
+    fflush( stdout );
+
+    uint64_t nBytes = 0;
+    Timer    timer;
+    timer.Start();
+
+#pragma omp parallel reduction(+:nBytes)
+    {
+        unsigned char *buffer = (unsigned char*) malloc( gnMaxSize + MAX_ALIGN );
+        uint64_t       aFailures[ nKernels ];
+        memset( aFailures, 0, sizeof( aFailures ) );
+
+#pragma omp for schedule(dynamic,1024)
+        for( int64_t iCase = (int64_t) nFirst; iCase < (int64_t) nLast; iCase++ )
+        {
+            Case test;
+            Case_Make( &test, (uint64_t) iCase, buffer );
+
+            const unsigned char *data = buffer + test.align;
+            nBytes += test.length;
+
+            ReferenceCache cache;
+            cache.nEntry = 0;
+
+            for( int iKernel = 0; iKernel < nKernels; iKernel++ )
+            {
+                if (!gaActive[ iKernel ])
+                    continue;
+
+                const Crc32Kernel *kernel = &aKernels[ iKernel ];
+                if (!Kernel_Fails( kernel, data, test.length, test.nSplit, test.aSplit, &cache ))
+                    continue;
+
+                aFailures[ iKernel ]++;
+
+#pragma omp critical
+                {
+                    if (!gaReported[ iKernel ])
+                    {
+                        gaReported[ iKernel ] = true;
+                        Report( kernel, &test, data );
+                        fflush( stdout );
+                    }
+                }
+            }
+        }
+
+#pragma omp critical
+        for( int iKernel = 0; iKernel < nKernels; iKernel++ )
+            gaFailures[ iKernel ] += aFailures[ iKernel ];
+
+        free( buffer );
+    }
+
+    timer.Stop();
+
+    uint64_t nFailures = 0;
+    for( int iKernel = 0; iKernel < nKernels; iKernel++ )
+    {
+        if (!gaActive[ iKernel ])
+            continue;
+
+        nFailures += gaFailures[ iKernel ];
+        if (gbVerbose || gaFailures[ iKernel ])
+            printf( "    %-24s %s  %llu failures\n", aKernels[ iKernel ].name, gaFailures[ iKernel ] ? "FAIL" : "OK  ", (unsigned long long) gaFailures[ iKernel ] );
+    }
+
+    const double rate = (nLast - nFirst) / timer.elapsed;
+    printf( "%llu failures, %llu MB hashed per kernel in %s, %.0f cases/s\n"
+        , (unsigned long long) nFailures
+        , (unsigned long long)(nBytes >> 20)
+        , timer.data.hms
+        , rate
+    );
+
+    return (nBad || nFailures) ? 1 : 0;
+}
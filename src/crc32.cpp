@@ -15,6 +15,11 @@ Usage:
     crc32 [text]
 
     text defaults to "123456789"
+
+The "tuned" CRC32B uses the kernel bin/autotune picked for this host,
+see util_tune.h.
+
+Set CRC32_PROFILE=1 to show where the time goes, see util_profile.h.
 */
 
 // Includes
@@ -22,11 +27,22 @@ Usage:
     #include <string.h>
 
     #include "common.cpp"
+    #include "util_bench.h"
+    #include "util_profile.h"
+    #include "crc32_kernels.h"
+    #include "util_tune.h"
 
 // ========================================================================
 int main( const int nArg, const char *aArg[] )
 {
-    common_init();
+    Profile_Init();
+    PROFILE_SCOPE( "crc32" );
+
+    {
+        PROFILE_SCOPE( "table init" );
+        common_init();
+    }
+    Tune_Load();
 
     const char *pArg = (nArg > 1)
         ? &aArg[1][0]
@@ -35,10 +51,13 @@ int main( const int nArg, const char *aArg[] )
     const int nLen = (int) strlen( pArg );
     const unsigned char *pData = (const unsigned char*) pArg;
 
+    PROFILE_SCOPE( "crc evaluation" );
+
     printf( "CRC32A = 0x%08X              \n", crc32a_formula_normal_noreverse( nLen, pData ) );
     printf( "CRC32B = 0x%08X; // '%s' (%d)\n", crc32b_table_reflect( nLen, pData ), pArg, nLen );
     printf( "forward = 0x%08X             \n", crc32_forward( nLen, pData ) );
     printf( "reverse = 0x%08X             \n", crc32_reverse( nLen, pData ) );
+    printf( "tuned   = 0x%08X; // %s\n", Tune_Crc32B( nLen, pData ), ((size_t) nLen <= gTune.small_size) ? gTune.kernel_small : gTune.kernel );
 
     return 0;
 }
@@ -146,6 +146,227 @@ History:
         return ~crc;
     }
 
+// ------------------------------------------------------------------------
+// Low cache footprint CRC32B
+// ------------------------------------------------------------------------
+// A 1 KB table, or 8 KB for slicing-by-8, is only fast while it is in L1.
+// Short messages hashed between other work pay for it twice: the table
+// misses, and the lines it evicts are missed by the caller afterwards.
+// Both of these are between the formula and the tables:
+//
+//     nibble   16 entries, 64 bytes, two lookups per byte
+//     clmul    no table, 64 bytes per 8 carry-less multiplies
+//
+// Measure them in context with bench -p.
+
+// Nibble: T[i] = CRC of the 4 bits i
+
+/* */     uint32_t CRC32_NIBBLE_REFLECT[16]; // init with poly = 0xEDB88320
+
+    // ========================================================================
+    void crc32_init_nibble_reflect( uint32_t NIBBLE[16], const uint32_t POLY = 0xEDB88320 )
+    {
+        for( int nibble = 0; nibble < 16; nibble++ )
+        {
+            uint32_t crc = (uint32_t) nibble;
+            for( int bit = 0; bit < 4; bit++ )
+            {
+                if( crc & 1 ) crc = (crc >> 1) ^ POLY;
+                else          crc = (crc >> 1);
+            }
+            NIBBLE[ nibble ] = crc;
+        }
+    }
+
+    // Reflected: crc >> 4, continues a register, no init or final xor
+    // ========================================================================
+    uint32_t crc32_update_nibble_reflect( const uint32_t NIBBLE[16], uint32_t crc, size_t len, const void *data )
+    {
+        LATENCY_SCOPE( "crc32_update_nibble_reflect", len );
+        const unsigned char *buffer = (const unsigned char*) data;
+
+        while( len-- )
+        {
+            crc = crc ^ *buffer++;
+            crc = NIBBLE[ crc & 0xF ] ^ (crc >> 4);
+            crc = NIBBLE[ crc & 0xF ] ^ (crc >> 4);
+        }
+        return crc;
+    }
+
+    // Reflected: crc >> 4, Data Bits: *buffer, Final CRC: ~crc, same as crc32_formula_reflect
+    // ========================================================================
+    uint32_t crc32_nibble_reflect( const uint32_t NIBBLE[16], size_t len, const void *data )
+    {
+        return ~crc32_update_nibble_reflect( NIBBLE, -1, len, data );
+    }
+
+// Clmul: Barrett reduction, PCLMULQDQ
+// 8 bytes V and the register R: R' = (V + R x^32) x^32 mod P.
+// With mu = x^96 / P - x^64, Barrett's quotient is q = V + (V mu) / x^64,
+// and R' = (q P) mod x^32, the x^32 term of P only touches higher bits.
+// Bit reflected a carry-less product is one bit short, so (V mu) / x^64
+// is the low half shifted left by one. Tails of 1..7 bytes are the same
+// with V shifted up, the register bits past the tail are xor'ed in after.
+//
+// 64 bytes or more are first folded, as Crc64_UpdateClmul() in crc_width.h,
+// in 4 independent lanes of 16 bytes, so the multiplies overlap instead of
+// waiting on one register. Moving a lane H x^64 + L forward by d bits is
+// H x^(d+64) + L x^d mod P, the product is 96 bits and stays in the lane.
+// The last lane is 16 bytes of message for the Barrett steps.
+
+    struct Crc32Clmul
+    {
+        uint64_t mu        ; // reflected, x^96 / P - x^64
+        uint64_t poly      ; // reflected, P - x^32
+        uint64_t fold[4]   ; // reflected, x^(d+63) and x^(d-1) mod P, d = 512, 128
+        uint32_t NIBBLE[16]; // without PCLMUL
+        bool     bClmul    ;
+    };
+
+    // @param normal - P - x^32, normal form
+    // @return x^n mod P, normal form
+    // ========================================================================
+    uint32_t crc32_pow_mod_normal( const uint32_t normal, int n )
+    {
+        uint32_t rem = 1;
+        while( n-- )
+            rem = (rem << 1) ^ ((rem >> 31) ? normal : 0);
+        return rem;
+    }
+
+/* */     Crc32Clmul CRC32_CLMUL_REFLECT; // init with poly = 0xEDB88320
+
+    // ========================================================================
+    void crc32_init_clmul_reflect( Crc32Clmul *clmul, const uint32_t POLY = 0xEDB88320 )
+    {
+        // Long division of x^96, the first quotient bit x^64 is implicit
+        const uint32_t normal = reverse32( POLY );
+        uint32_t       rem    = normal;
+        uint64_t       mu     = 0;
+
+        for( int bit = 63; bit >= 0; bit-- )
+        {
+            const uint32_t top = rem >> 31;
+            mu  |= (uint64_t) top << bit;
+            rem  = (rem << 1) ^ (top ? normal : 0);
+        }
+
+        clmul->mu     = reverse64( mu );
+        clmul->poly   = (uint64_t) POLY << 32;
+
+        // The reflected product is one bit short, times x
+        const int aDistance[4] = { 512 + 63, 512 - 1, 128 + 63, 128 - 1 };
+        for( int iFold = 0; iFold < 4; iFold++ )
+            clmul->fold[ iFold ] = reverse64( crc32_pow_mod_normal( normal, aDistance[ iFold ] ) );
+
+        clmul->bClmul = Cpu_HasPCLMUL();
+        crc32_init_nibble_reflect( clmul->NIBBLE, POLY );
+    }
+
+#if CPU_X86
+    // @return V x^32 mod P, V bit reflected
+    // ========================================================================
+    TARGET_PCLMUL
+    inline __m128i crc32_barrett_reflect( const __m128i k, const __m128i v )
+    {
+        const __m128i q = _mm_xor_si128( v, _mm_slli_epi64( _mm_clmulepi64_si128( v, k, 0x00 ), 1 ) );
+        return _mm_srli_si128( _mm_srli_epi64( _mm_clmulepi64_si128( q, k, 0x10 ), 31 ), 8 );
+    }
+
+    // Fold a 128-bit lane forward by the distance of k, see Crc64_Fold()
+    // ========================================================================
+    TARGET_PCLMUL
+    inline __m128i crc32_fold( const __m128i x, const __m128i k )
+    {
+        return _mm_xor_si128( _mm_clmulepi64_si128( x, k, 0x00 ), _mm_clmulepi64_si128( x, k, 0x11 ) );
+    }
+
+    // 8 bytes at a time
+    // ========================================================================
+    TARGET_PCLMUL
+    uint32_t crc32_update_barrett_reflect_x86( const Crc32Clmul *clmul, uint32_t crc, size_t len, const void *data )
+    {
+        const unsigned char *buffer = (const unsigned char*) data;
+        const __m128i        k      = _mm_set_epi64x( (int64_t) clmul->poly, (int64_t) clmul->mu );
+              __m128i        r      = _mm_cvtsi32_si128( (int) crc );
+
+        for( ; len >= 8; len -= 8, buffer += 8 )
+            r = crc32_barrett_reflect( k, _mm_xor_si128( r, _mm_loadl_epi64( (const __m128i*) buffer ) ) );
+        crc = (uint32_t) _mm_cvtsi128_si32( r );
+
+        if (len)
+        {
+            uint64_t tail = 0;
+            for( size_t byte = 0; byte < len; byte++ )
+                tail |= (uint64_t) buffer[ byte ] << (8 * byte);
+
+            const uint64_t v    = (tail ^ crc) << (64 - 8 * len);
+            const uint32_t rest = (len < 4) ? (crc >> (8 * len)) : 0;
+            crc = (uint32_t) _mm_cvtsi128_si32( crc32_barrett_reflect( k, _mm_set_epi64x( 0, (int64_t) v ) ) ) ^ rest;
+        }
+        return crc;
+    }
+
+    // 64 bytes at a time, then 16, then 8
+    // ========================================================================
+    TARGET_PCLMUL
+    uint32_t crc32_update_clmul_reflect_x86( const Crc32Clmul *clmul, uint32_t crc, size_t len, const void *data )
+    {
+        const unsigned char *buffer = (const unsigned char*) data;
+        if (len < 64)
+            return crc32_update_barrett_reflect_x86( clmul, crc, len, buffer );
+
+        const __m128i k512 = _mm_set_epi64x( (int64_t) clmul->fold[1], (int64_t) clmul->fold[0] );
+        const __m128i k128 = _mm_set_epi64x( (int64_t) clmul->fold[3], (int64_t) clmul->fold[2] );
+
+        __m128i x0 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)(buffer +  0) ), _mm_cvtsi32_si128( (int) crc ) );
+        __m128i x1 =                _mm_loadu_si128( (const __m128i*)(buffer + 16) );
+        __m128i x2 =                _mm_loadu_si128( (const __m128i*)(buffer + 32) );
+        __m128i x3 =                _mm_loadu_si128( (const __m128i*)(buffer + 48) );
+
+        for( buffer += 64, len -= 64; len >= 64; buffer += 64, len -= 64 )
+        {
+            x0 = _mm_xor_si128( crc32_fold( x0, k512 ), _mm_loadu_si128( (const __m128i*)(buffer +  0) ) );
+            x1 = _mm_xor_si128( crc32_fold( x1, k512 ), _mm_loadu_si128( (const __m128i*)(buffer + 16) ) );
+            x2 = _mm_xor_si128( crc32_fold( x2, k512 ), _mm_loadu_si128( (const __m128i*)(buffer + 32) ) );
+            x3 = _mm_xor_si128( crc32_fold( x3, k512 ), _mm_loadu_si128( (const __m128i*)(buffer + 48) ) );
+        }
+
+        __m128i x = _mm_xor_si128( crc32_fold( x0, k128 ), x1 );
+        x = _mm_xor_si128( crc32_fold( x, k128 ), x2 );
+        x = _mm_xor_si128( crc32_fold( x, k128 ), x3 );
+
+        for( ; len >= 16; buffer += 16, len -= 16 )
+            x = _mm_xor_si128( crc32_fold( x, k128 ), _mm_loadu_si128( (const __m128i*) buffer ) );
+
+        unsigned char last[ 16 ];
+        _mm_storeu_si128( (__m128i*) last, x );
+
+        crc = crc32_update_barrett_reflect_x86( clmul, 0, sizeof( last ), last );
+        return crc32_update_barrett_reflect_x86( clmul, crc, len, buffer );
+    }
+#endif // CPU_X86
+
+    // Reflected, continues a register, no init or final xor
+    // ========================================================================
+    uint32_t crc32_update_clmul_reflect( const Crc32Clmul *clmul, uint32_t crc, size_t len, const void *data )
+    {
+        LATENCY_SCOPE( "crc32_update_clmul_reflect", len );
+#if CPU_X86
+        if (clmul->bClmul)
+            return crc32_update_clmul_reflect_x86( clmul, crc, len, data );
+#endif
+        return crc32_update_nibble_reflect( clmul->NIBBLE, crc, len, data );
+    }
+
+    // Reflected, Data Bits: *buffer, Final CRC: ~crc, same as crc32_formula_reflect
+    // ========================================================================
+    uint32_t crc32_clmul_reflect( const Crc32Clmul *clmul, size_t len, const void *data )
+    {
+        return ~crc32_update_clmul_reflect( clmul, -1, len, data );
+    }
+
 // ------------------------------------------------------------------------
 // Table-driven CRC32B
 // ------------------------------------------------------------------------
@@ -193,6 +414,7 @@ History:
     // ========================================================================
     uint32_t crc32_000( const uint32_t *CRC32, size_t len, const void *data )
     {
+        LATENCY_SCOPE( "crc32_000", len );
         const unsigned char *buffer = (const unsigned char*) data;
         uint32_t crc = -1;
 
@@ -205,6 +427,7 @@ History:
     // ========================================================================
     uint32_t crc32_001( const uint32_t *CRC32, size_t len, const void *data )
     {
+        LATENCY_SCOPE( "crc32_001", len );
         const unsigned char *buffer = (const unsigned char*) data;
         uint32_t crc = -1;
 
@@ -217,6 +440,7 @@ History:
     // ========================================================================
     uint32_t crc32_010( const uint32_t *CRC32, size_t len, const void *data )
     {
+        LATENCY_SCOPE( "crc32_010", len );
         const unsigned char *buffer = (const unsigned char*) data;
         uint32_t crc = -1;
 
@@ -230,6 +454,7 @@ History:
     // ========================================================================
     uint32_t crc32_011( const uint32_t *CRC32, size_t len, const void *data )
     {
+        LATENCY_SCOPE( "crc32_011", len );
         const unsigned char *buffer = (const unsigned char*) data;
         uint32_t crc = -1;
 
@@ -244,6 +469,7 @@ History:
     // ========================================================================
     uint32_t crc32_100( const uint32_t *CRC32, size_t len, const void *data )
     {
+        LATENCY_SCOPE( "crc32_100", len );
         const unsigned char *buffer = (const unsigned char*) data;
         uint32_t crc = -1;
 
@@ -261,6 +487,7 @@ History:
     // ========================================================================
     uint32_t crc32_110( const uint32_t *CRC32, size_t len, const void *data )
     {
+        LATENCY_SCOPE( "crc32_110", len );
         const unsigned char *buffer = (const unsigned char*) data;
         uint32_t crc = -1;
 
@@ -273,6 +500,7 @@ History:
     // ========================================================================
     uint32_t crc32_101( const uint32_t *CRC32, size_t len, const void *data )
     {
+        LATENCY_SCOPE( "crc32_101", len );
         const unsigned char *buffer = (const unsigned char*) data;
         uint32_t crc = -1;
 
@@ -285,6 +513,7 @@ History:
     // ========================================================================
     uint32_t crc32_111( const uint32_t *CRC32, size_t len, const void *data )
     {
+        LATENCY_SCOPE( "crc32_111", len );
         const unsigned char *buffer = (const unsigned char*) data;
         uint32_t crc = -1;
 
@@ -293,6 +522,325 @@ History:
         return reverse32( ~crc );
     }
 
+// Streaming
+
+    // Normal: crc << 8, continues a register, no init or final xor
+    // ========================================================================
+    uint32_t crc32_update_normal( const uint32_t *CRC32, uint32_t crc, size_t len, const void *data )
+    {
+        LATENCY_SCOPE( "crc32_update_normal", len );
+        const unsigned char *buffer = (const unsigned char*) data;
+
+        while( len-- )
+            crc = CRC32[ (        *buffer++  ^ (crc >> 24)) & 0xFF ] ^ (crc << 8);
+        return crc;
+    }
+
+    // Reflected: crc >> 8, continues a register, no init or final xor
+    // ========================================================================
+    uint32_t crc32_update_reflect( const uint32_t *CRC32, uint32_t crc, size_t len, const void *data )
+    {
+        LATENCY_SCOPE( "crc32_update_reflect", len );
+        const unsigned char *buffer = (const unsigned char*) data;
+
+        while( len-- )
+            crc = CRC32[ (crc ^         *buffer++ ) & 0xFF ] ^ (crc >> 8);
+        return crc;
+    }
+
+// Slicing-by-8
+// 8 tables, T[k][i] = CRC of byte i followed by k zero bytes, so 8 bytes
+// are 8 independent lookups instead of a chain of 8 dependent ones.
+// Normal form reads the bytes big endian, Reflected little endian.
+
+/* */     uint32_t CRC32_SLICE8_NORMAL [8][256]; // init with poly = 0x04C11DB7
+/* */     uint32_t CRC32_SLICE8_REFLECT[8][256]; // init with poly = 0xEDB88320
+/* */     uint32_t CRC32C_SLICE8_REFLECT[8][256]; // init with poly = 0x82F63B78
+
+    // Slices 1..7 from any table in slice 0, it only has to be linear
+    // ========================================================================
+    void crc32_extend_slice8_normal( uint32_t CRC32[8][256] )
+    {
+        for( int slice = 1; slice < 8; slice++ )
+            for( int byte = 0; byte < 256; byte++ )
+                CRC32[ slice ][ byte ] = CRC32[0][ CRC32[ slice-1 ][ byte ] >> 24 ] ^ (CRC32[ slice-1 ][ byte ] << 8);
+    }
+
+    // ========================================================================
+    void crc32_extend_slice8_reflect( uint32_t CRC32[8][256] )
+    {
+        for( int slice = 1; slice < 8; slice++ )
+            for( int byte = 0; byte < 256; byte++ )
+                CRC32[ slice ][ byte ] = CRC32[0][ CRC32[ slice-1 ][ byte ] & 0xFF ] ^ (CRC32[ slice-1 ][ byte ] >> 8);
+    }
+
+    // ========================================================================
+    void crc32_init_slice8_normal( uint32_t CRC32[8][256], const uint32_t POLY = 0x04C11DB7 )
+    {
+        crc32_init_normal( CRC32[0], POLY );
+        crc32_extend_slice8_normal( CRC32 );
+    }
+
+    // ========================================================================
+    void crc32_init_slice8_reflect( uint32_t CRC32[8][256], const uint32_t POLY = 0xEDB88320 )
+    {
+        crc32_init_reflect( CRC32[0], POLY );
+        crc32_extend_slice8_reflect( CRC32 );
+    }
+
+    // Normal: crc << 8, continues a register, no init or final xor
+    // ========================================================================
+    uint32_t crc32_update_slice8_normal( const uint32_t CRC32[8][256], uint32_t crc, size_t len, const void *data )
+    {
+        LATENCY_SCOPE( "crc32_update_slice8_normal", len );
+        const unsigned char *buffer = (const unsigned char*) data;
+
+        for( ; len >= 8; len -= 8, buffer += 8 )
+        {
+            const uint32_t one = crc ^ (
+                  ((uint32_t) buffer[0] << 24)
+                | ((uint32_t) buffer[1] << 16)
+                | ((uint32_t) buffer[2] <<  8)
+                | ((uint32_t) buffer[3] <<  0) );
+
+            // Bytes 4..7 don't depend on crc, look them up off the critical path
+            const uint32_t two = CRC32[3][ buffer[4] ]
+                               ^ CRC32[2][ buffer[5] ]
+                               ^ CRC32[1][ buffer[6] ]
+                               ^ CRC32[0][ buffer[7] ];
+
+            crc = two
+                ^ (CRC32[7][  one >> 24         ] ^ CRC32[6][ (one >> 16) & 0xFF ])
+                ^ (CRC32[5][ (one >>  8) & 0xFF ] ^ CRC32[4][ (one >>  0) & 0xFF ]);
+        }
+
+        while( len-- )
+            crc = CRC32[0][ (*buffer++ ^ (crc >> 24)) & 0xFF ] ^ (crc << 8);
+        return crc;
+    }
+
+    // Reflected: crc >> 8, continues a register, no init or final xor
+    // ========================================================================
+    uint32_t crc32_update_slice8_reflect( const uint32_t CRC32[8][256], uint32_t crc, size_t len, const void *data )
+    {
+        LATENCY_SCOPE( "crc32_update_slice8_reflect", len );
+        const unsigned char *buffer = (const unsigned char*) data;
+
+        for( ; len >= 8; len -= 8, buffer += 8 )
+        {
+            const uint32_t one = crc ^ (
+                  ((uint32_t) buffer[0] <<  0)
+                | ((uint32_t) buffer[1] <<  8)
+                | ((uint32_t) buffer[2] << 16)
+                | ((uint32_t) buffer[3] << 24) );
+
+            const uint32_t two = CRC32[3][ buffer[4] ]
+                               ^ CRC32[2][ buffer[5] ]
+                               ^ CRC32[1][ buffer[6] ]
+                               ^ CRC32[0][ buffer[7] ];
+
+            crc = two
+                ^ (CRC32[7][ (one >>  0) & 0xFF ] ^ CRC32[6][ (one >>  8) & 0xFF ])
+                ^ (CRC32[5][ (one >> 16) & 0xFF ] ^ CRC32[4][  one >> 24         ]);
+        }
+
+        while( len-- )
+            crc = CRC32[0][ (crc ^ *buffer++) & 0xFF ] ^ (crc >> 8);
+        return crc;
+    }
+
+    // Normal: crc << 8, Data Bits: *buffer, Final CRC: ~crc, same as crc32_000
+    // ========================================================================
+    uint32_t crc32_slice8_normal( const uint32_t CRC32[8][256], size_t len, const void *data )
+    {
+        return ~crc32_update_slice8_normal( CRC32, -1, len, data );
+    }
+
+    // Reflected: crc >> 8, Data Bits: *buffer, Final CRC: ~crc, same as crc32_100
+    // ========================================================================
+    uint32_t crc32_slice8_reflect( const uint32_t CRC32[8][256], size_t len, const void *data )
+    {
+        return ~crc32_update_slice8_reflect( CRC32, -1, len, data );
+    }
+
+// ------------------------------------------------------------------------
+// Fixed length CRC32C
+// ------------------------------------------------------------------------
+// Hash table keys have a length known at compile time, so there is no
+// loop or length check left, only a few instructions:
+//
+//     crc32c_u32( key )           4 bytes of key, little endian
+//     crc32c_u64( key )           8 bytes of key, little endian
+//     crc32c_fixed<N>( key )      N bytes at key
+//
+// all the same as crc32c_reverse() of those bytes. SSE 4.2 has a CRC32C
+// instruction, 8 bytes per 3 cycles latency. Built with -msse4.2 it is
+// inlined, otherwise called after one predictable branch. Without it,
+// slicing-by-8 is unrolled.
+
+/* */     bool gbCrc32cHw = false; // SSE 4.2, set by CRC32_Init()
+
+    // ========================================================================
+    inline uint32_t crc32c_slice_u32( uint32_t crc, const uint32_t key )
+    {
+        const uint32_t (*T)[256] = CRC32C_SLICE8_REFLECT;
+        crc ^= key;
+        return T[3][ crc & 0xFF ] ^ T[2][ (crc >> 8) & 0xFF ] ^ T[1][ (crc >> 16) & 0xFF ] ^ T[0][ crc >> 24 ];
+    }
+
+    // ========================================================================
+    inline uint32_t crc32c_slice_u64( uint32_t crc, const uint64_t key )
+    {
+        const uint32_t (*T)[256] = CRC32C_SLICE8_REFLECT;
+        const uint32_t one       = crc ^ (uint32_t) key;
+        const uint32_t two       = (uint32_t)(key >> 32);
+
+        return T[7][ one & 0xFF ] ^ T[6][ (one >> 8) & 0xFF ] ^ T[5][ (one >> 16) & 0xFF ] ^ T[4][ one >> 24 ]
+             ^ T[3][ two & 0xFF ] ^ T[2][ (two >> 8) & 0xFF ] ^ T[1][ (two >> 16) & 0xFF ] ^ T[0][ two >> 24 ];
+    }
+
+    // ========================================================================
+    inline uint64_t crc32c_load_le( const unsigned char *data, const size_t len )
+    {
+        uint64_t key = 0;
+        for( size_t byte = 0; byte < len; byte++ )
+            key |= (uint64_t) data[ byte ] << (8 * byte);
+        return key;
+    }
+
+    // Continues a register, no init or final xor
+    // ========================================================================
+    template<size_t N>
+    inline uint32_t crc32c_update_fixed_slice( uint32_t crc, const unsigned char *data )
+    {
+        for( size_t offset = 0; offset + 8 <= N; offset += 8 )
+            crc = crc32c_slice_u64( crc, crc32c_load_le( data + offset, 8 ) );
+        if (N & 4)
+            crc = crc32c_slice_u32( crc, (uint32_t) crc32c_load_le( data + (N & ~7), 4 ) );
+        for( size_t offset = N & ~3; offset < N; offset++ )
+            crc = CRC32C_SLICE8_REFLECT[0][ (crc ^ data[ offset ]) & 0xFF ] ^ (crc >> 8);
+        return crc;
+    }
+
+#if CPU_X86
+    // ========================================================================
+    TARGET_SSE42
+    inline uint32_t crc32c_hw_u64( uint32_t crc, const uint64_t key )
+    {
+    #if defined(__x86_64__) || defined(_M_X64)
+        return (uint32_t) _mm_crc32_u64( crc, key );
+    #else
+        return _mm_crc32_u32( _mm_crc32_u32( crc, (uint32_t) key ), (uint32_t)(key >> 32) );
+    #endif
+    }
+
+    // ========================================================================
+    template<size_t N>
+    TARGET_SSE42
+    inline uint32_t crc32c_update_fixed_hw( uint32_t crc, const unsigned char *data )
+    {
+        for( size_t offset = 0; offset + 8 <= N; offset += 8 )
+        {
+            uint64_t key;
+            memcpy( &key, data + offset, 8 );
+            crc = crc32c_hw_u64( crc, key );
+        }
+        if (N & 4)
+        {
+            uint32_t key;
+            memcpy( &key, data + (N & ~7), 4 );
+            crc = _mm_crc32_u32( crc, key );
+        }
+        for( size_t offset = N & ~3; offset < N; offset++ )
+            crc = _mm_crc32_u8( crc, data[ offset ] );
+        return crc;
+    }
+
+    // Continues a register, no init or final xor
+    // ========================================================================
+    TARGET_SSE42
+    uint32_t crc32c_update_hw( uint32_t crc, size_t len, const void *data )
+    {
+        const unsigned char *buffer = (const unsigned char*) data;
+
+        for( ; len >= 8; len -= 8, buffer += 8 )
+        {
+            uint64_t key;
+            memcpy( &key, buffer, 8 );
+            crc = crc32c_hw_u64( crc, key );
+        }
+        while( len-- )
+            crc = _mm_crc32_u8( crc, *buffer++ );
+        return crc;
+    }
+
+    // Out of line, a TARGET_SSE42 function isn't inlined into generic code
+    // ========================================================================
+    TARGET_SSE42 uint32_t crc32c_u32_hw( const uint32_t key ) { return ~_mm_crc32_u32( ~0u, key ); }
+    TARGET_SSE42 uint32_t crc32c_u64_hw( const uint64_t key ) { return ~crc32c_hw_u64( ~0u, key ); }
+
+    template<size_t N>
+    TARGET_SSE42 uint32_t crc32c_fixed_hw( const void *key ) { return ~crc32c_update_fixed_hw<N>( ~0u, (const unsigned char*) key ); }
+#endif // CPU_X86
+
+    // Any length, SSE 4.2 or slicing-by-8, continues a register, no init or final xor
+    // ========================================================================
+    uint32_t crc32c_update( uint32_t crc, size_t len, const void *data )
+    {
+        LATENCY_SCOPE( "crc32c_update", len );
+#if CPU_X86
+        if (gbCrc32cHw)
+            return crc32c_update_hw( crc, len, data );
+#endif
+        return crc32_update_slice8_reflect( CRC32C_SLICE8_REFLECT, crc, len, data );
+    }
+
+    // ========================================================================
+    inline uint32_t crc32c_u32( const uint32_t key )
+    {
+        LATENCY_SCOPE( "crc32c_u32", 4 );
+#if CPU_X86 && defined(__SSE4_2__)
+        return ~_mm_crc32_u32( ~0u, key );
+#else
+    #if CPU_X86
+        if (gbCrc32cHw)
+            return crc32c_u32_hw( key );
+    #endif
+        return ~crc32c_slice_u32( ~0u, key );
+#endif
+    }
+
+    // ========================================================================
+    inline uint32_t crc32c_u64( const uint64_t key )
+    {
+        LATENCY_SCOPE( "crc32c_u64", 8 );
+#if CPU_X86 && defined(__SSE4_2__)
+        return ~crc32c_hw_u64( ~0u, key );
+#else
+    #if CPU_X86
+        if (gbCrc32cHw)
+            return crc32c_u64_hw( key );
+    #endif
+        return ~crc32c_slice_u64( ~0u, key );
+#endif
+    }
+
+    // ========================================================================
+    template<size_t N>
+    inline uint32_t crc32c_fixed( const void *key )
+    {
+        LATENCY_SCOPE( "crc32c_fixed", N );
+#if CPU_X86 && defined(__SSE4_2__)
+        return ~crc32c_update_fixed_hw<N>( ~0u, (const unsigned char*) key );
+#else
+    #if CPU_X86
+        if (gbCrc32cHw)
+            return crc32c_fixed_hw<N>( key );
+    #endif
+        return ~crc32c_update_fixed_slice<N>( ~0u, (const unsigned char*) key );
+#endif
+    }
+
 // ========================================================================
 void CRC32_Init()
 {
@@ -319,11 +867,20 @@ void CRC32_Init()
     if (CRC32_REVERSE  [8] != (POLY_REVERSE >> 4)) printf( "ERROR: CRC32 Reverse Table not initialized properly! 0x%08X != 0x%08X\n", CRC32_REVERSE  [8], POLY_REVERSE );
     if (CRC32_FORWARD  [1] !=  POLY_FORWARD      ) printf( "ERROR: CRC32 Forward Table not initialized properly! 0x%08x != 0x%08X\n", CRC32_FORWARD  [1], POLY_FORWARD );
     if (CRC32_FORWARD [16] != (POLY_FORWARD << 4)) printf( "ERROR: CRC32 Forward Table not initialized properly! 0x%08x != 0x%08X\n", CRC32_FORWARD [16], POLY_FORWARD );
+
+    crc32_init_slice8_normal ( CRC32_SLICE8_NORMAL , POLY_FORWARD );
+    crc32_init_slice8_reflect( CRC32_SLICE8_REFLECT, POLY_REVERSE );
+    crc32_init_nibble_reflect( CRC32_NIBBLE_REFLECT, POLY_REVERSE );
+    crc32_init_clmul_reflect ( &CRC32_CLMUL_REFLECT, POLY_REVERSE );
+
+    crc32_init_slice8_reflect( CRC32C_SLICE8_REFLECT, CRC32C_POLY_REVERSE );
+    gbCrc32cHw = Cpu_HasSSE42();
 }
 
 // ========================================================================
 unsigned int crc32_forward( size_t nLength, const unsigned char *pData )
 {
+    LATENCY_SCOPE( "crc32_forward", nLength );
     unsigned int crc = -1; // CRC32_INIT
     while( nLength --> 0 )
         crc = CRC32_FORWARD[ ((crc >> 24) ^ REVERSE_BITS[*pData++]) & 0xFF ] ^ (crc << 8); // normal form
@@ -333,6 +890,7 @@ unsigned int crc32_forward( size_t nLength, const unsigned char *pData )
 // ========================================================================
 unsigned int crc32_reverse( size_t nLength, const unsigned char *pData )
 {
+    LATENCY_SCOPE( "crc32_reverse", nLength );
     unsigned int crc = -1; // CRC32_INIT
     while( nLength --> 0 )
         crc = CRC32_REVERSE[ (crc         ^              *pData++ ) & 0xFF ] ^ (crc >> 8); // reverse/reflected form
@@ -342,6 +900,7 @@ unsigned int crc32_reverse( size_t nLength, const unsigned char *pData )
 // ========================================================================
 uint32_t crc32c_reverse( size_t nLength, const unsigned char *pData )
 {
+    LATENCY_SCOPE( "crc32c_reverse", nLength );
     unsigned int crc = ~0UL;
     while( nLength --> 0 )
         crc = CRC32C_REVERSED[ (crc ^ *pData++ ) & 0xFF ] ^ (crc >> 8); // reverse/reflected form
@@ -0,0 +1,50 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Running the reflected CRC backwards.
+
+One reflected step is:
+
+    next = CRC32[ (crc ^ byte) & 0xFF ] ^ (crc >> 8)
+
+Since (crc >> 8) has a zero top byte, the top byte of next is the top byte
+of CRC32[ index ]. For a valid polynomial all 256 top bytes are unique, so
+a 256 entry table maps the top byte back to the index, recovering crc:
+
+    index = INVERSE[ next >> 24 ]
+    crc   = ((next ^ CRC32[ index ]) << 8) | (index ^ byte)
+
+*/
+
+// Implementation
+
+    // @return false if the table's top bytes aren't unique (broken polynomial)
+    // ========================================================================
+    bool crc32_init_inverse( const uint32_t *CRC32, uint8_t *INVERSE )
+    {
+        bool bSeen[ 256 ] = { false };
+
+        for( int index = 0; index < 256; index++ )
+        {
+            const uint8_t top = CRC32[ index ] >> 24;
+            if (bSeen[ top ])
+                return false;
+
+            bSeen  [ top ] = true;
+            INVERSE[ top ] = (uint8_t) index;
+        }
+        return true;
+    }
+
+    // Undo one reflected step of byte
+    // ========================================================================
+    inline uint32_t crc32_unstep( const uint32_t *CRC32, const uint8_t *INVERSE, const uint32_t next, const uint8_t byte )
+    {
+        const uint8_t index = INVERSE[ next >> 24 ];
+        return ((next ^ CRC32[ index ]) << 8) | (uint8_t)(index ^ byte);
+    }
@@ -0,0 +1,130 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Registry of every CRC32 kernel, shared by bench and conform.
+
+Each kernel has the same Crc32Func signature, its check value of
+"123456789", and the formula reference it must match for any input:
+
+    reference_crc32a     crc32a_formula_normal_noreverse(), CRC32 A
+    reference_crc32b     crc32_formula_reflect( POLY_REVERSE ), CRC32 B, zlib
+    reference_crc32c     crc32_formula_reflect( CRC32C_POLY_REVERSE )
+    _rev                 the same, final CRC bit reversed
+
+Kernels that can continue a previous CRC also have a stream function.
+It follows the zlib convention: the crc in and out is the finished CRC,
+start with 0, and stream( stream( 0, a ), b ) = func( a + b ).
+
+A new kernel only has to be added to aKernels to be benchmarked and
+conformance tested.
+
+Define USE_ZLIB 1 and link -lz to include the system zlib crc32().
+
+*/
+
+// Types
+
+    typedef uint32_t (*Crc32Stream)( uint32_t crc, size_t length, const unsigned char *data );
+
+    struct Crc32Kernel
+    {
+        const char *name     ;
+        Crc32Func   func     ;
+        uint32_t    check    ; // of "123456789"
+        Crc32Func   reference;
+        Crc32Stream stream   ; // optional
+    };
+
+// References
+
+    uint32_t reference_crc32a    ( size_t len, const unsigned char *data ) { return           crc32a_formula_normal_noreverse( len, data )  ; }
+    uint32_t reference_crc32a_rev( size_t len, const unsigned char *data ) { return reverse32( crc32a_formula_normal_noreverse( len, data ) ); }
+    uint32_t reference_crc32b    ( size_t len, const unsigned char *data ) { return           crc32_formula_reflect( POLY_REVERSE, len, data )  ; }
+    uint32_t reference_crc32b_rev( size_t len, const unsigned char *data ) { return reverse32( crc32_formula_reflect( POLY_REVERSE, len, data ) ); }
+    uint32_t reference_crc32c    ( size_t len, const unsigned char *data ) { return           crc32_formula_reflect( CRC32C_POLY_REVERSE, len, data ); }
+
+// Kernels
+    // Table and formula kernels take extra arguments, wrap them as Crc32Func
+
+    uint32_t kernel_000( size_t len, const unsigned char *data ) { return crc32_000( aCRC32, len, data ); }
+    uint32_t kernel_001( size_t len, const unsigned char *data ) { return crc32_001( aCRC32, len, data ); }
+    uint32_t kernel_010( size_t len, const unsigned char *data ) { return crc32_010( aCRC32, len, data ); }
+    uint32_t kernel_011( size_t len, const unsigned char *data ) { return crc32_011( aCRC32, len, data ); }
+    uint32_t kernel_100( size_t len, const unsigned char *data ) { return crc32_100( dCRC32, len, data ); }
+    uint32_t kernel_101( size_t len, const unsigned char *data ) { return crc32_101( dCRC32, len, data ); }
+    uint32_t kernel_110( size_t len, const unsigned char *data ) { return crc32_110( dCRC32, len, data ); }
+    uint32_t kernel_111( size_t len, const unsigned char *data ) { return crc32_111( dCRC32, len, data ); }
+
+    uint32_t kernel_formula_normal ( size_t len, const unsigned char *data ) { return crc32_formula_normal ( POLY_FORWARD, len, data ); }
+    uint32_t kernel_formula_reflect( size_t len, const unsigned char *data ) { return crc32_formula_reflect( POLY_REVERSE, len, data ); }
+    uint32_t kernel_formula_a      ( size_t len, const unsigned char *data ) { return crc32a_formula_normal_noreverse( len, data ); }
+
+    uint32_t kernel_slice8_normal ( size_t len, const unsigned char *data ) { return crc32_slice8_normal ( CRC32_SLICE8_NORMAL , len, data ); }
+    uint32_t kernel_slice8_reflect( size_t len, const unsigned char *data ) { return crc32_slice8_reflect( CRC32_SLICE8_REFLECT, len, data ); }
+    uint32_t kernel_slice8_crc32c ( size_t len, const unsigned char *data ) { return crc32_slice8_reflect( CRC32C_SLICE8_REFLECT, len, data ); }
+    uint32_t kernel_crc32c        ( size_t len, const unsigned char *data ) { return ~crc32c_update( ~0u, len, data ); }
+
+    uint32_t kernel_nibble_reflect( size_t len, const unsigned char *data ) { return crc32_nibble_reflect( CRC32_NIBBLE_REFLECT, len, data ); }
+    uint32_t kernel_clmul_reflect ( size_t len, const unsigned char *data ) { return crc32_clmul_reflect ( &CRC32_CLMUL_REFLECT, len, data ); }
+
+    uint32_t stream_000   ( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32_update_normal ( aCRC32         , ~crc, len, data ); }
+    uint32_t stream_100   ( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32_update_reflect( dCRC32         , ~crc, len, data ); }
+    uint32_t stream_crc32c( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32_update_reflect( CRC32C_REVERSED, ~crc, len, data ); }
+    uint32_t stream_slice8_normal ( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32_update_slice8_normal ( CRC32_SLICE8_NORMAL , ~crc, len, data ); }
+    uint32_t stream_slice8_reflect( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32_update_slice8_reflect( CRC32_SLICE8_REFLECT, ~crc, len, data ); }
+    uint32_t stream_slice8_crc32c ( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32_update_slice8_reflect( CRC32C_SLICE8_REFLECT, ~crc, len, data ); }
+    uint32_t stream_crc32c_update ( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32c_update( ~crc, len, data ); }
+    uint32_t stream_nibble_reflect( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32_update_nibble_reflect( CRC32_NIBBLE_REFLECT, ~crc, len, data ); }
+    uint32_t stream_clmul_reflect ( uint32_t crc, size_t len, const unsigned char *data ) { return ~crc32_update_clmul_reflect ( &CRC32_CLMUL_REFLECT, ~crc, len, data ); }
+
+#if USE_ZLIB
+    uint32_t stream_zlib( uint32_t crc, size_t len, const unsigned char *data )
+    {
+        while( len ) // zlib takes uInt lengths
+        {
+            const uInt size = (len > (1u << 30)) ? (1u << 30) : (uInt) len;
+            crc   = (uint32_t) crc32( crc, data, size );
+            data += size;
+            len  -= size;
+        }
+        return crc;
+    }
+
+    uint32_t kernel_zlib( size_t len, const unsigned char *data ) { return stream_zlib( 0, len, data ); }
+#endif
+
+// Registry
+
+    const Crc32Kernel aKernels[] =
+    {
+        //  Name                      Function                Check       Reference             Stream
+         { "crc32_000"              , kernel_000            , 0xFC891918, reference_crc32a    , stream_000    }
+        ,{ "crc32_001"              , kernel_001            , 0x1898913F, reference_crc32a_rev, NULL          }
+        ,{ "crc32_010"              , kernel_010            , 0x649C2FD3, reference_crc32b_rev, NULL          }
+        ,{ "crc32_011"              , kernel_011            , 0xCBF43926, reference_crc32b    , NULL          }
+        ,{ "crc32_100"              , kernel_100            , 0xCBF43926, reference_crc32b    , stream_100    }
+        ,{ "crc32_101"              , kernel_101            , 0x649C2FD3, reference_crc32b_rev, NULL          }
+        ,{ "crc32_110"              , kernel_110            , 0x1898913F, reference_crc32a_rev, NULL          }
+        ,{ "crc32_111"              , kernel_111            , 0xFC891918, reference_crc32a    , NULL          }
+        ,{ "crc32_formula_normal"   , kernel_formula_normal , 0xCBF43926, reference_crc32b    , NULL          }
+        ,{ "crc32_formula_reflect"  , kernel_formula_reflect, 0xCBF43926, reference_crc32b    , NULL          }
+        ,{ "crc32a_formula_normal"  , kernel_formula_a      , 0xFC891918, reference_crc32a    , NULL          }
+        ,{ "crc32_forward"          , crc32_forward         , 0xCBF43926, reference_crc32b    , NULL          }
+        ,{ "crc32_reverse"          , crc32_reverse         , 0xCBF43926, reference_crc32b    , NULL          }
+        ,{ "crc32_slice8_normal"    , kernel_slice8_normal  , 0xFC891918, reference_crc32a    , stream_slice8_normal  }
+        ,{ "crc32_slice8_reflect"   , kernel_slice8_reflect , 0xCBF43926, reference_crc32b    , stream_slice8_reflect }
+        ,{ "crc32_nibble_reflect"   , kernel_nibble_reflect , 0xCBF43926, reference_crc32b    , stream_nibble_reflect }
+        ,{ "crc32_clmul_reflect"    , kernel_clmul_reflect  , 0xCBF43926, reference_crc32b    , stream_clmul_reflect  }
+        ,{ "crc32c_reverse"         , crc32c_reverse        , 0xE3069283, reference_crc32c    , stream_crc32c }
+        ,{ "crc32c_slice8_reflect"  , kernel_slice8_crc32c  , 0xE3069283, reference_crc32c    , stream_slice8_crc32c  }
+        ,{ "crc32c_update"          , kernel_crc32c         , 0xE3069283, reference_crc32c    , stream_crc32c_update  }
+#if USE_ZLIB
+        ,{ "zlib crc32"             , kernel_zlib           , 0xCBF43926, reference_crc32b    , stream_zlib   }
+#endif
+    };
+    const int nKernels = sizeof( aKernels ) / sizeof( aKernels[0] );
@@ -0,0 +1,387 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Named CRC32 models, and a fused engine that advances every catalogued
+model in one pass over the data:
+
+    Family: aData[ 4 tables ] x aFunc[ 8 forms ] = CRC32Id 0 .. 31
+    Named : standard models such as CRC-32/ISO-HDLC, CRC-32C, ...
+
+The 8 aFunc forms only differ in shift direction, data bit order, and
+final bit order, and most of the 44 CRCs share a register:
+
+  * The final bit order doesn't change the register.
+  * Reversed data bits are the mirror image of shifting the other way
+    with the mirrored table, i.e. crc32_010( aCRC32 ) = crc32_100( dCRC32 )
+    bit reversed, so only plain data registers are kept.
+  * Named models differing only in xorout, i.e. CRC-32/MPEG-2 and
+    CRC-32/BZIP2, or matching a family form, share its register.
+
+Each of the remaining 16 registers runs on its own fast kernel, see
+crc32_rewrite.h: PCLMUL folding for real CRC tables, else slicing-by-8.
+Long buffers are fed in blocks that stay in the L1 cache, so the data is
+read from memory once for all 44 CRCs. The registers are independent, so
+with OpenMP each thread runs its own group of them over the same blocks.
+
+Must include crc32_rewrite.h first.
+Must call common_init() before Crc32Models_Init().
+
+*/
+
+// Types
+
+    // Parameters as in the "Catalogue of parametrised CRC algorithms"
+    // Poly is always in normal form, reflected models use reflect32( poly )
+    struct Crc32Model
+    {
+        const char *name   ;
+        uint32_t    poly   ;
+        bool        reflect; // input and output
+        uint32_t    init   ;
+        uint32_t    xorout ;
+        uint32_t    check  ; // of "123456789"
+    };
+
+// Consts
+
+    constexpr Crc32Model aModels[] =
+    {
+        //  Name                  Poly        Ref    Init        XorOut      Check
+         { "CRC-32/ISO-HDLC"   , 0x04C11DB7, true , 0xFFFFFFFF, 0xFFFFFFFF, 0xCBF43926 } // zlib, Ethernet, PNG
+        ,{ "CRC-32/BZIP2"      , 0x04C11DB7, false, 0xFFFFFFFF, 0xFFFFFFFF, 0xFC891918 }
+        ,{ "CRC-32/MPEG-2"     , 0x04C11DB7, false, 0xFFFFFFFF, 0x00000000, 0x0376E6E7 }
+        ,{ "CRC-32/CKSUM"      , 0x04C11DB7, false, 0x00000000, 0xFFFFFFFF, 0x765E7680 } // POSIX, without the length
+        ,{ "CRC-32/JAMCRC"     , 0x04C11DB7, true , 0xFFFFFFFF, 0x00000000, 0x340BC6D9 }
+        ,{ "CRC-32/ISCSI"      , 0x1EDC6F41, true , 0xFFFFFFFF, 0xFFFFFFFF, 0xE3069283 } // CRC32C
+        ,{ "CRC-32/BASE91-D"   , 0xA833982B, true , 0xFFFFFFFF, 0xFFFFFFFF, 0x87315576 } // CRC32D
+        ,{ "CRC-32/AUTOSAR"    , 0xF4ACFB13, true , 0xFFFFFFFF, 0xFFFFFFFF, 0x1697D06A }
+        ,{ "CRC-32/MEF"        , 0x741B8CD7, true , 0xFFFFFFFF, 0x00000000, 0xD2C22F51 } // CRC32K
+        ,{ "CRC-32/AIXM"       , 0x814141AB, false, 0x00000000, 0x00000000, 0x3010BF7F } // CRC32Q
+        ,{ "CRC-32/XFER"       , 0x000000AF, false, 0x00000000, 0x00000000, 0xBD0BE338 }
+        ,{ "CRC-32/CD-ROM-EDC" , 0x8001801B, true , 0x00000000, 0x00000000, 0x6EC2EDC4 }
+    };
+    const int nModels = sizeof( aModels ) / sizeof( aModels[0] );
+
+// Compile Time CRC
+// constexpr from the same aModels[], so the CRC of a string literal folds
+// to a constant and can be a case label:
+//
+//     switch( ~crc32c_update( ~0u, length, name ) )
+//     {
+//         case "open"_crc32c : ...
+//         case "close"_crc32c: ...
+//     }
+//
+// A bit at a time, for identifiers, not data. Needs C++14.
+
+    // ========================================================================
+    constexpr bool Crc32Model_Equal( const char *a, const char *b )
+    {
+        while( *a && (*a == *b) )
+            a++, b++;
+        return *a == *b;
+    }
+
+    // @return index in aModels[], nModels if there is no such name
+    // ========================================================================
+    constexpr int Crc32Model_Find( const char *name )
+    {
+        int iModel = 0;
+        while( (iModel < nModels) && !Crc32Model_Equal( aModels[ iModel ].name, name ) )
+            iModel++;
+        return iModel;
+    }
+
+    // ========================================================================
+    constexpr uint32_t Crc32Model_Reflect( const uint32_t x )
+    {
+        uint32_t y = 0;
+        for( int bit = 0; bit < 32; bit++ )
+            y |= ((x >> bit) & 1) << (31 - bit);
+        return y;
+    }
+
+    // ========================================================================
+    constexpr uint32_t Crc32Model_Eval( const Crc32Model &model, size_t len, const char *text )
+    {
+        const uint32_t poly = model.reflect ? Crc32Model_Reflect( model.poly ) : model.poly;
+        uint32_t       crc  = model.reflect ? Crc32Model_Reflect( model.init ) : model.init;
+
+        while( len-- )
+        {
+            const uint32_t byte = (unsigned char) *text++;
+            if (model.reflect)
+            {
+                crc ^= byte;
+                for( int bit = 0; bit < 8; bit++ )
+                    crc = (crc & 1) ? (crc >> 1) ^ poly : (crc >> 1);
+            }
+            else
+            {
+                crc ^= byte << 24;
+                for( int bit = 0; bit < 8; bit++ )
+                    crc = (crc >> 31) ? (crc << 1) ^ poly : (crc << 1);
+            }
+        }
+        return crc ^ model.xorout;
+    }
+
+    // A missing name reads past aModels[], which won't compile
+    // ========================================================================
+    constexpr uint32_t Crc32Model_EvalName( const char *name, size_t len, const char *text )
+    {
+        return Crc32Model_Eval( aModels[ Crc32Model_Find( name ) ], len, text );
+    }
+
+    constexpr uint32_t operator"" _crc32 ( const char *text, size_t len ) { return Crc32Model_EvalName( "CRC-32/ISO-HDLC", len, text ); }
+    constexpr uint32_t operator"" _crc32c( const char *text, size_t len ) { return Crc32Model_EvalName( "CRC-32/ISCSI"   , len, text ); }
+
+    // @return true if every model's check value matches
+    // ========================================================================
+    constexpr bool Crc32Model_CheckAll()
+    {
+        for( int iModel = 0; iModel < nModels; iModel++ )
+            if (Crc32Model_Eval( aModels[ iModel ], 9, "123456789" ) != aModels[ iModel ].check)
+                return false;
+        return true;
+    }
+
+    static_assert( Crc32Model_CheckAll(), "aModels[] check value doesn't match Crc32Model_Eval()" );
+    static_assert( "123456789"_crc32  == 0xCBF43926, "_crc32"  );
+    static_assert( "123456789"_crc32c == 0xE3069283, "_crc32c" );
+
+    // Check values of "123456789" by CRC32Id
+    const uint32_t CRC32Family[32] =
+    {
+        //                 Polynomial reversed?
+        //                  Reflected?
+        //                   Shift Right?
+        //                    Data Reversed?
+        //                     CRC Reversed?
+        //     Hash    Id  PRSDC
+         0xFC891918 //  0 [00000] 0x04C11DB7
+        ,0x1898913F //  1 [00001]
+        ,0x649C2FD3 //  2 [00010]
+        ,0xCBF43926 //  3 [00011]
+        ,0x7EAD5C77 //  4 [00100]
+        ,0xEE3AB57E //  5 [00101]
+        ,0x0D0B7023 //  6 [00110]
+        ,0xC40ED0B0 //  7 [00111]
+
+        ,0xC9A0B7E5 //  8 [01000]
+        ,0xA7ED0593 //  9 [01001]
+        ,0x9D594C04 // 10 [01010]
+        ,0x20329AB9 // 11 [01011]
+        ,0xFC4F2BE9 // 12 [01100]
+        ,0x97D4F23F // 13 [01101]
+        ,0xFDEFB72E // 14 [01110]
+        ,0x74EDF7BF // 15 [01111]
+   
+        ,0x74EDF7BF // 16 [01000] 0xEDB88320
+        ,0xFDEFB72E // 17 [01001]
+        ,0x97D4F23F // 18 [01010]
+        ,0xFC4F2BE9 // 19 [01011]
+        ,0x20329AB9 // 20 [01100]
+        ,0x9D594C04 // 21 [01101]
+        ,0xA7ED0593 // 22 [01110]
+        ,0xC9A0B7E5 // 23 [01111]
+
+        ,0xC40ED0B0 // 24 [11000]
+        ,0x0D0B7023 // 25 [11001]
+        ,0xEE3AB57E // 26 [11010]
+        ,0x7EAD5C77 // 27 [11011]
+        ,0xCBF43926 // 28 [11100]
+        ,0x649C2FD3 // 29 [11101]
+        ,0x1898913F // 30 [11110]
+        ,0xFC891918 // 31 [11111]
+        //                 0 = 0x04C11DB7
+        //                 1 = 0xEDB88320
+        //                  0 = Normal
+        //                  1 = Reflected
+        //                   0 = Left
+        //                   1 = Right
+    };
+
+// Vars
+
+    const int    MAX_FUSED   = 32;
+    const size_t FUSED_BLOCK = 16 * 1024; // data per pass over the registers
+
+    // Unique registers, all fed plain data bytes
+    Crc32Rewrite gaFusedKernel[ MAX_FUSED ];
+    uint32_t     gaFusedInit  [ MAX_FUSED ];
+    int          gaFusedOrder [ MAX_FUSED ]; // dealt out to threads in this order
+    int          gnFused     = 0;
+
+    // Outputs
+    int      gaFamilyReg   [ 32 ]; // by CRC32Id
+    bool     gaFamilyMirror[ 32 ];
+    int      gaModelReg    [ nModels ];
+
+// Fused State
+
+    struct Crc32Fused
+    {
+        uint32_t reg[ MAX_FUSED ];
+    };
+
+// Implementation
+
+    // Returns the register for table/shift/init, adding it if it's new
+    // ========================================================================
+    int Crc32Fused_Register( const uint32_t *CRC32, const bool bRight, const uint32_t init )
+    {
+        for( int iReg = 0; iReg < gnFused; iReg++ )
+            if ((gaFusedInit  [ iReg ]        == init  )
+            &&  (gaFusedKernel[ iReg ].bRight == bRight)
+            &&  !memcmp( gaFusedKernel[ iReg ].SLICE8[0], CRC32, 256 * sizeof( uint32_t ) ))
+                return iReg;
+
+        Crc32Rewrite_Init( &gaFusedKernel[ gnFused ], CRC32, bRight ? 4 : 0 ); // aFunc 000 or 100
+        gaFusedInit[ gnFused ] = init;
+        gnFused++;
+
+        // Slicing is ~10x slower than folding, so deal those out first
+        int nOrder = 0;
+        for( int bFold = 0; bFold < 2; bFold++ )
+            for( int iReg = 0; iReg < gnFused; iReg++ )
+                if ((gaFusedKernel[ iReg ].kernel != REWRITE_SLICE8) == (bFold != 0))
+                    gaFusedOrder[ nOrder++ ] = iReg;
+
+        return gnFused - 1;
+    }
+
+    // ========================================================================
+    void Crc32Fused_Begin( Crc32Fused *state )
+    {
+        for( int iReg = 0; iReg < gnFused; iReg++ )
+            state->reg[ iReg ] = gaFusedInit[ iReg ];
+    }
+
+    // ========================================================================
+    void Crc32Fused_Update( Crc32Fused *state, size_t len, const void *data )
+    {
+        LATENCY_SCOPE( "Crc32Fused_Update", len );
+
+        const unsigned char *buffer = (const unsigned char*) data;
+
+        // No barrier per block: each thread only touches its own registers
+#pragma omp parallel if (len > FUSED_BLOCK)
+        {
+            int iThread = 0;
+            int nThread = 1;
+#ifdef _OPENMP
+            iThread = omp_get_thread_num ();
+            nThread = omp_get_num_threads();
+#endif
+            for( size_t offset = 0; offset < len; offset += FUSED_BLOCK )
+            {
+                const size_t size = (len - offset < FUSED_BLOCK) ? len - offset : FUSED_BLOCK;
+
+                for( int iOrder = iThread; iOrder < gnFused; iOrder += nThread )
+                {
+                    const int iReg = gaFusedOrder[ iOrder ];
+                    state->reg[ iReg ] = Crc32Rewrite_Update( &gaFusedKernel[ iReg ], state->reg[ iReg ], size, buffer + offset );
+                }
+            }
+        }
+    }
+
+    // @param aFamily - [32] indexed by CRC32Id
+    // @param aNamed  - [nModels] indexed as aModels
+    // ========================================================================
+    void Crc32Fused_End( const Crc32Fused *state, uint32_t *aFamily, uint32_t *aNamed )
+    {
+        for( int id = 0; id < 32; id++ )
+        {
+            const uint32_t reg = state->reg[ gaFamilyReg[ id ] ];
+            const uint32_t crc = ~(gaFamilyMirror[ id ] ? reverse32( reg ) : reg);
+            aFamily[ id ] = (id & 1) ? reverse32( crc ) : crc;
+        }
+
+        for( int iModel = 0; iModel < nModels; iModel++ )
+            aNamed[ iModel ] = state->reg[ gaModelReg[ iModel ] ] ^ aModels[ iModel ].xorout;
+    }
+
+    // @return number of models whose check value doesn't match
+    // ========================================================================
+    int Crc32Models_Init()
+    {
+        uint32_t CRC32[ 256 ];
+
+        gnFused = 0;
+
+        for( int bRight = 0; bRight < 2; bRight++ )
+        {
+            for( int iTable = 0; iTable < 4; iTable++ )
+            {
+                const int id = iTable*8 + bRight*4; // Data as is, CRC as is
+                gaFamilyReg   [ id ] = Crc32Fused_Register( aData[ iTable ], bRight, -1 );
+                gaFamilyMirror[ id ] = false;
+            }
+
+            for( int iModel = 0; iModel < nModels; iModel++ )
+            {
+                const Crc32Model *model = &aModels[ iModel ];
+                if (model->reflect != (bRight != 0))
+                    continue;
+
+                if (model->reflect)
+                    crc32_init_reflect( CRC32, reflect32( model->poly ) );
+                else
+                    crc32_init_normal ( CRC32, model->poly );
+
+                gaModelReg[ iModel ] = Crc32Fused_Register( CRC32, bRight, model->reflect ? reflect32( model->init ) : model->init );
+            }
+        }
+
+        // Reversed data is the mirror image of the other shift direction with
+        // the mirrored table: aCRC32 <-> dCRC32 and bCRC32 <-> cCRC32
+        for( int id = 0; id < 32; id++ )
+        {
+            const int iTable    = id >> 3;
+            const int isShiftR  = (id >> 2) & 1;
+            const int isRevData = (id >> 1) & 1;
+
+            if (isRevData)
+            {
+                gaFamilyReg   [ id ] = gaFamilyReg[ (3 - iTable)*8 + (!isShiftR)*4 ];
+                gaFamilyMirror[ id ] = true;
+            }
+            else
+            {
+                gaFamilyReg   [ id ] = gaFamilyReg[ iTable*8 + isShiftR*4 ];
+                gaFamilyMirror[ id ] = false;
+            }
+        }
+
+        // Verify against the check value and the aFunc forms
+        Crc32Fused state;
+        uint32_t   aFamily[ 32 ], aNamed[ nModels ];
+        int        nBad = 0;
+
+        Crc32Fused_Begin ( &state );
+        Crc32Fused_Update( &state, strlen( CRC32_CHECK_TXT ), CRC32_CHECK_TXT );
+        Crc32Fused_End   ( &state, aFamily, aNamed );
+
+        for( int iModel = 0; iModel < nModels; iModel++ )
+            if (aNamed[ iModel ] != aModels[ iModel ].check)
+            {
+                printf( "ERROR: %s check 0x%08X != 0x%08X\n", aModels[ iModel ].name, aNamed[ iModel ], aModels[ iModel ].check );
+                nBad++;
+            }
+
+        for( int id = 0; id < 32; id++ )
+            if (aFamily[ id ] != aFunc[ id & 7 ]( aData[ id >> 3 ], strlen( CRC32_CHECK_TXT ), CRC32_CHECK_TXT ))
+            {
+                printf( "ERROR: Fused CRC32Id %d doesn't match aFunc[%d]\n", id, id & 7 );
+                nBad++;
+            }
+
+        return nBad;
+    }
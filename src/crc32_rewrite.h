@@ -0,0 +1,178 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Rewrites any table CRC permutation, aData[] x aFunc[] or any other table
+with a crc32_SDC form, onto one fast kernel plus an O(1) fixup:
+
+    Crc32Rewrite rewrite;
+    Crc32Rewrite_Init( &rewrite, bCRC32, 6 );          // crc32_110( bCRC32 )
+    crc = Crc32Rewrite_Crc( &rewrite, length, data );
+
+  * Reversed data bits are the mirror image of shifting the other way,
+    with the mirrored table T'[i] = reverse32( T[ reverse8( i ) ] ) and
+    the result bit reversed, see crc32_models.h. The register starts at
+    -1 and ends with ~, both mirror symmetric, so no data is reversed.
+  * The final bit reversal is done once, or cancels out with the above.
+  * Slicing-by-8 only needs the table to be linear, which every table
+    built by shifting and xor'ing is, even the "broken" bCRC32 and cCRC32
+    or a table used with the wrong shift. So every form gets slicing.
+  * A table that is a real CRC table, of T[128] shifting right or of
+    T[1] shifting left, gets PCLMUL folding, or without it the SSE 4.2
+    CRC32C instruction for CRC32C.
+
+Must include common.h first.
+
+*/
+
+// Consts
+
+    enum Crc32RewriteKernel
+    {
+         REWRITE_SLICE8
+        ,REWRITE_CLMUL
+        ,REWRITE_SSE42
+    };
+
+    const char *gaRewriteKernel[] = { "slicing-by-8", "clmul", "sse4.2" };
+
+// Types
+
+    struct Crc32Rewrite
+    {
+        int        kernel  ; // Crc32RewriteKernel
+        bool       bRight  ; // shift of the kernel
+        bool       bReverse; // reverse32() its CRC
+        uint32_t   poly    ; // reflected CRC poly of the table, 0 = not a CRC table
+        uint32_t   SLICE8[8][256];
+        Crc32Clmul clmul   ; // shift right
+        uint64_t   fold[4] ; // shift left, x^(d+64) and x^d mod P, d = 512, 128
+    };
+
+// Implementation
+
+    // @param form - aFunc[] index, bits: Shift Right, Data Reversed, CRC Reversed
+    // ========================================================================
+    void Crc32Rewrite_Init( Crc32Rewrite *rewrite, const uint32_t *CRC32, const int form )
+    {
+        const bool bShiftR  = ((form >> 2) & 1) != 0;
+        const bool bRevData = ((form >> 1) & 1) != 0;
+        const bool bRevCRC  = ((form >> 0) & 1) != 0;
+
+        for( int byte = 0; byte < 256; byte++ )
+            rewrite->SLICE8[0][ byte ] = bRevData
+                ? reverse32( CRC32[ REVERSE_BITS[ byte ] ] )
+                :            CRC32[               byte   ];
+
+        rewrite->bRight   = bShiftR != bRevData;
+        rewrite->bReverse = bRevCRC != bRevData;
+        rewrite->kernel   = REWRITE_SLICE8;
+        rewrite->poly     = 0;
+
+        if (rewrite->bRight)
+            crc32_extend_slice8_reflect( rewrite->SLICE8 );
+        else
+            crc32_extend_slice8_normal ( rewrite->SLICE8 );
+
+        uint32_t table[ 256 ];
+        if (rewrite->bRight)
+            crc32_init_reflect( table, rewrite->SLICE8[0][128] );
+        else
+            crc32_init_normal ( table, rewrite->SLICE8[0][  1] );
+        if (memcmp( table, rewrite->SLICE8[0], sizeof( table ) ))
+            return;
+
+        rewrite->poly = rewrite->bRight ? rewrite->SLICE8[0][128] : reverse32( rewrite->SLICE8[0][1] );
+
+        if (!rewrite->bRight)
+        {
+            const int aDistance[4] = { 512 + 64, 512, 128 + 64, 128 };
+            for( int iFold = 0; iFold < 4; iFold++ )
+                rewrite->fold[ iFold ] = crc32_pow_mod_normal( rewrite->SLICE8[0][1], aDistance[ iFold ] );
+            if (Cpu_HasPCLMUL())
+                rewrite->kernel = REWRITE_CLMUL;
+            return;
+        }
+
+        // Folding is ~3x the CRC32 instruction, which has one register
+        crc32_init_clmul_reflect( &rewrite->clmul, rewrite->poly );
+        if (rewrite->clmul.bClmul)
+            rewrite->kernel = REWRITE_CLMUL;
+        else if ((rewrite->poly == CRC32C_POLY_REVERSE) && gbCrc32cHw)
+            rewrite->kernel = REWRITE_SSE42;
+    }
+
+#if CPU_X86
+    // Normal: the lanes are byte swapped so the first message bit is x^127,
+    // then folded as crc32_update_clmul_reflect_x86() without the extra x,
+    // the last lane is finished with the table
+    // ========================================================================
+    TARGET_PCLMUL
+    uint32_t Crc32Rewrite_UpdateClmulNormal( const Crc32Rewrite *rewrite, uint32_t crc, size_t len, const void *data )
+    {
+        const unsigned char *buffer = (const unsigned char*) data;
+        if (len < 64)
+            return crc32_update_slice8_normal( rewrite->SLICE8, crc, len, buffer );
+
+        const __m128i swap = _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+        const __m128i k512 = _mm_set_epi64x( (int64_t) rewrite->fold[0], (int64_t) rewrite->fold[1] );
+        const __m128i k128 = _mm_set_epi64x( (int64_t) rewrite->fold[2], (int64_t) rewrite->fold[3] );
+
+        __m128i x0 = _mm_xor_si128( _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)(buffer +  0) ), swap ), _mm_set_epi32( (int) crc, 0, 0, 0 ) );
+        __m128i x1 =                _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)(buffer + 16) ), swap );
+        __m128i x2 =                _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)(buffer + 32) ), swap );
+        __m128i x3 =                _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)(buffer + 48) ), swap );
+
+        for( buffer += 64, len -= 64; len >= 64; buffer += 64, len -= 64 )
+        {
+            x0 = _mm_xor_si128( crc32_fold( x0, k512 ), _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)(buffer +  0) ), swap ) );
+            x1 = _mm_xor_si128( crc32_fold( x1, k512 ), _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)(buffer + 16) ), swap ) );
+            x2 = _mm_xor_si128( crc32_fold( x2, k512 ), _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)(buffer + 32) ), swap ) );
+            x3 = _mm_xor_si128( crc32_fold( x3, k512 ), _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)(buffer + 48) ), swap ) );
+        }
+
+        __m128i x = _mm_xor_si128( crc32_fold( x0, k128 ), x1 );
+        x = _mm_xor_si128( crc32_fold( x, k128 ), x2 );
+        x = _mm_xor_si128( crc32_fold( x, k128 ), x3 );
+
+        for( ; len >= 16; buffer += 16, len -= 16 )
+            x = _mm_xor_si128( crc32_fold( x, k128 ), _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*) buffer ), swap ) );
+
+        unsigned char last[ 16 ];
+        _mm_storeu_si128( (__m128i*) last, _mm_shuffle_epi8( x, swap ) );
+
+        crc = crc32_update_slice8_normal( rewrite->SLICE8, 0, sizeof( last ), last );
+        return crc32_update_slice8_normal( rewrite->SLICE8, crc, len, buffer );
+    }
+#endif // CPU_X86
+
+    // Continues the kernel's register, no init or final xor
+    // ========================================================================
+    uint32_t Crc32Rewrite_Update( const Crc32Rewrite *rewrite, uint32_t crc, size_t len, const void *data )
+    {
+        switch( rewrite->kernel )
+        {
+            case REWRITE_SSE42: return crc32c_update             ( crc, len, data );
+#if CPU_X86
+            case REWRITE_CLMUL: return rewrite->bRight
+                ? crc32_update_clmul_reflect    ( &rewrite->clmul, crc, len, data )
+                : Crc32Rewrite_UpdateClmulNormal( rewrite        , crc, len, data );
+#endif
+            default:
+                return rewrite->bRight
+                    ? crc32_update_slice8_reflect( rewrite->SLICE8, crc, len, data )
+                    : crc32_update_slice8_normal ( rewrite->SLICE8, crc, len, data );
+        }
+    }
+
+    // Same as aFunc[ form ]( CRC32, len, data )
+    // ========================================================================
+    uint32_t Crc32Rewrite_Crc( const Crc32Rewrite *rewrite, size_t len, const void *data )
+    {
+        const uint32_t crc = Crc32Rewrite_Update( rewrite, ~0u, len, data );
+        return rewrite->bReverse ? reverse32( ~crc ) : ~crc;
+    }
@@ -1,3 +1,4 @@
+#define USE_OMP 1
 #if _WIN32
     #define _CRT_SECURE_NO_WARNINGS 1
 #endif
@@ -5,56 +6,19 @@
 #include "common.cpp"
 #include <ctype.h> // isspace()
 
-const uint32_t CRC32Family[32]
-{
-    //                 Polynomial reversed?
-    //                  Reflected?
-    //                   Shift Right?
-    //                    Data Reversed?
-    //                     CRC Reversed?
-    //     Hash    Id  PRSDC
-     0xFC891918 //  0 [00000] 0x04C11DB7
-    ,0x1898913F //  1 [00001]
-    ,0x649C2FD3 //  2 [00010]
-    ,0xCBF43926 //  3 [00011]
-    ,0x7EAD5C77 //  4 [00100]
-    ,0xEE3AB57E //  5 [00101]
-    ,0x0D0B7023 //  6 [00110]
-    ,0xC40ED0B0 //  7 [00111]
-
-    ,0xC9A0B7E5 //  8 [01000]
-    ,0xA7ED0593 //  9 [01001]
-    ,0x9D594C04 // 10 [01010]
-    ,0x20329AB9 // 11 [01011]
-    ,0xFC4F2BE9 // 12 [01100]
-    ,0x97D4F23F // 13 [01101]
-    ,0xFDEFB72E // 14 [01110]
-    ,0x74EDF7BF // 15 [01111]
-   
-    ,0x74EDF7BF // 16 [01000] 0xEDB88320
-    ,0xFDEFB72E // 17 [01001]
-    ,0x97D4F23F // 18 [01010]
-    ,0xFC4F2BE9 // 19 [01011]
-    ,0x20329AB9 // 20 [01100]
-    ,0x9D594C04 // 21 [01101]
-    ,0xA7ED0593 // 22 [01110]
-    ,0xC9A0B7E5 // 23 [01111]
-
-    ,0xC40ED0B0 // 24 [11000]
-    ,0x0D0B7023 // 25 [11001]
-    ,0xEE3AB57E // 26 [11010]
-    ,0x7EAD5C77 // 27 [11011]
-    ,0xCBF43926 // 28 [11100]
-    ,0x649C2FD3 // 29 [11101]
-    ,0x1898913F // 30 [11110]
-    ,0xFC891918 // 31 [11111]
-    //                 0 = 0x04C11DB7
-    //                 1 = 0xEDB88320
-    //                  0 = Normal
-    //                  1 = Reflected
-    //                   0 = Left
-    //                   1 = Right
-};
+// BEGIN OMP
+#if USE_OMP
+    #include <omp.h>
+#endif
+    #include "util_threads.h"
+    #include "util_timer.h"
+// END OMP
+    #include "util_bench.h"
+    #include "util_profile.h"
+    #include "crc32_rewrite.h"
+    #include "crc32_models.h"
+    #include "crc32_kernels.h"
+    #include "util_tune.h"
 
 // returns -1 if couldn't identify
 int CRC32Id(const uint32_t poly, const uint32_t hash)
@@ -86,19 +50,21 @@ void CRC32Analysis(const uint32_t crc32id)
     int isRevData = (crc32id >> 1) & 1;
     int isRevCRC  = (crc32id >> 0) & 1;
 
-    const int       iFunc = (crc32id >> 3) & 3;
-    const uint32_t *pData = aData[ iFunc ];
-    const char     *pDesc = aDesc[ iFunc ];
+    const int       iTable = (crc32id >> 3) & 3;
+    const uint32_t *pData  = aData[ iTable ];
 
     const char   *text   = CRC32_CHECK_TXT;
     const size_t  length = strlen( text );
 
     const char *aNoYes[2] = { "No ", "Yes" };
 
-    uint32_t crc = aFunc[ iFunc ]( pData, length, text ); 
+    // Same as aFunc[ crc32id & 7 ]( pData, ... ), at slicing or PCLMUL speed
+    static Crc32Rewrite rewrite;
+    Crc32Rewrite_Init( &rewrite, pData, crc32id & 7 );
+    uint32_t crc = Crc32Rewrite_Crc( &rewrite, length, text );
 
     printf( "Poly: %08X   Reflect: %s  Normal: %s  Shift: %s, Rev. Data: %d, Rev. CRC: %d, 0x%08X\n"
-        , aPoly[ iFunc ]
+        , aPoly[ iTable ]
         , aNoYes[ isReflect ]
         , aNoYes[ isNormal ]
         , isShiftR
@@ -108,12 +74,930 @@ void CRC32Analysis(const uint32_t crc32id)
         , isRevCRC
         , crc
     );
+    printf( "Fast: shift %s, %s%s\n"
+        , rewrite.bRight ? "right" : "left"
+        , gaRewriteKernel[ rewrite.kernel ]
+        , rewrite.bReverse ? ", bit reversed CRC" : ""
+    );
+}
+
+// Polynomial Recovery
+//
+// Given (data, crc) samples from an unknown CRC32, try every polynomial in both forms:
+//
+//     Normal   : crc << 1, data as is        = crc32a_formula_normal_noreverse()
+//     Reflected: crc >> 1, data as is        = crc32_formula_reflect()
+//
+// A generator polynomial always has the x^0 term, so only odd normal
+// polynomials, and reflected polynomials with bit 31 set, need trying: 2^31 each.
+//
+// The shortest sample is tested for 32 polynomials at a time with AVX2.
+// About 1 in 2^32 polynomials pass by chance, so survivors are checked
+// against the other samples with the scalar formula.
+//
+// Init and XorOut
+//
+// For a fixed polynomial a CRC is affine over GF(2):
+//
+//     crc( data ) = L( data ) ^ Z_n( init ) ^ xorout
+//
+// where L is the CRC with init = 0 and xorout = 0, and Z_n( init ) is the
+// register after running n zero bytes from init; both are linear. XORing two
+// samples of the same length n cancels init and xorout:
+//
+//     crc1 ^ crc2 = L( data1 ^ data2 )
+//
+// so when there are same-length pairs the polynomial search uses those
+// differentials (init = 0, xorout = 0) and doesn't assume init or xorout.
+// Each surviving polynomial then gives 32 linear equations per sample in the
+// 64 unknown bits of init and xorout:
+//
+//     Z_n( init ) ^ xorout = crc ^ L( data )
+//
+// which Gaussian elimination solves directly. Samples of at least two different
+// lengths are needed to separate init from xorout. If the polynomial has a
+// factor in common with x^(8*(n1-n2)) - 1, e.g. x+1 for an even number of terms,
+// some (init, xorout) pairs give the same CRC for those lengths and all are
+// reported as one solution of 2^free. Init is the register value as the kernel
+// uses it, i.e. already reflected for the reflected form.
+
+    const int MAX_SAMPLES   = 16;
+    const int MAX_POLY_HITS = 64;
+
+    struct Sample
+    {
+        unsigned char *data  ;
+        size_t         length;
+        uint32_t       crc   ;
+        uint32_t       init  ; // assumed during the polynomial search
+        uint32_t       xorout;
+    };
+
+    Sample gaSamples[ MAX_SAMPLES ];
+    int    gnSamples = 0;
+
+    Sample gaSearch [ MAX_SAMPLES ]; // samples, or same-length differentials
+    int    gnSearch  = 0;
+
+    uint32_t gnPolyGiven = 0; // -p, skips the search
+
+    uint32_t gaPolyFound[ 2 ][ MAX_POLY_HITS ]; // [bReflect]
+    int      gnPolyFound[ 2 ];
+
+    // Bit-serial register update without init or final xor
+    // ========================================================================
+    uint32_t crc32_poly_raw( const bool bReflect, const uint32_t POLY, uint32_t crc, size_t len, const unsigned char *buffer )
+    {
+        if (bReflect)
+            while( len-- )
+            {
+                crc = crc ^ (buffer ? *buffer++ : 0);
+                for( int bit = 0; bit < 8; bit++ )
+                {
+                    if( crc & 1 ) crc = (crc >> 1) ^ POLY;
+                    else          crc = (crc >> 1);
+                }
+            }
+        else
+            while( len-- )
+            {
+                crc = crc ^ ((buffer ? *buffer++ : 0) << 24);
+                for( int bit = 0; bit < 8; bit++ )
+                {
+                    if( crc & (1L << 31)) crc = (crc << 1) ^ POLY;
+                    else                  crc = (crc << 1);
+                }
+            }
+        return crc;
+    }
+
+    // ========================================================================
+    inline uint32_t PolySample( const bool bReflect, const uint32_t poly, const Sample *sample )
+    {
+        return crc32_poly_raw( bReflect, poly, sample->init, sample->length, sample->data ) ^ sample->xorout;
+    }
+
+    // Test count polynomials first, first + step, ... against the sample
+    // @return number of matches written to aHit
+    // ========================================================================
+    int PolySearch_Scalar( const bool bReflect, const uint32_t first, const uint32_t step, const uint32_t count, const Sample *sample, uint32_t *aHit, const int nHitMax )
+    {
+        int nHit = 0;
+        for( uint32_t i = 0; i < count; i++ )
+        {
+            const uint32_t poly = first + i*step;
+            if ((PolySample( bReflect, poly, sample ) == sample->crc) && (nHit < nHitMax))
+                aHit[ nHit++ ] = poly;
+        }
+        return nHit;
+    }
+
+#if CPU_X86
+    // count must be a multiple of 32
+    // ========================================================================
+    TARGET_AVX2
+    int PolySearch_AVX2( const bool bReflect, const uint32_t first, const uint32_t step, const uint32_t count, const Sample *sample, uint32_t *aHit, const int nHitMax )
+    {
+        const __m256i lanes  = _mm256_mullo_epi32( _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ), _mm256_set1_epi32( step ) );
+        const __m256i next   = _mm256_set1_epi32( 8 * step );
+        const __m256i target = _mm256_set1_epi32( sample->crc ^ sample->xorout ); // crc before final xor
+        const __m256i init   = _mm256_set1_epi32( sample->init );
+              int     nHit   = 0;
+
+        for( uint32_t i = 0; i < count; i += 32 )
+        {
+            // 4 independent chains hide the shift/and/xor latency
+            __m256i p0 = _mm256_add_epi32( _mm256_set1_epi32( first + i*step ), lanes );
+            __m256i p1 = _mm256_add_epi32( p0, next );
+            __m256i p2 = _mm256_add_epi32( p1, next );
+            __m256i p3 = _mm256_add_epi32( p2, next );
+            __m256i c0 = init, c1 = init, c2 = init, c3 = init;
+
+            const unsigned char *buffer = sample->data;
+            for( size_t len = sample->length; len--; buffer++ )
+            {
+                if (bReflect)
+                {
+                    const __m256i byte = _mm256_set1_epi32( *buffer );
+                    c0 = _mm256_xor_si256( c0, byte );
+                    c1 = _mm256_xor_si256( c1, byte );
+                    c2 = _mm256_xor_si256( c2, byte );
+                    c3 = _mm256_xor_si256( c3, byte );
+                    for( int bit = 0; bit < 8; bit++ )
+                    {
+                        // if( crc & 1 ) crc = (crc >> 1) ^ POLY;
+                        c0 = _mm256_xor_si256( _mm256_srli_epi32( c0, 1 ), _mm256_and_si256( p0, _mm256_srai_epi32( _mm256_slli_epi32( c0, 31 ), 31 ) ) );
+                        c1 = _mm256_xor_si256( _mm256_srli_epi32( c1, 1 ), _mm256_and_si256( p1, _mm256_srai_epi32( _mm256_slli_epi32( c1, 31 ), 31 ) ) );
+                        c2 = _mm256_xor_si256( _mm256_srli_epi32( c2, 1 ), _mm256_and_si256( p2, _mm256_srai_epi32( _mm256_slli_epi32( c2, 31 ), 31 ) ) );
+                        c3 = _mm256_xor_si256( _mm256_srli_epi32( c3, 1 ), _mm256_and_si256( p3, _mm256_srai_epi32( _mm256_slli_epi32( c3, 31 ), 31 ) ) );
+                    }
+                }
+                else
+                {
+                    const __m256i byte = _mm256_set1_epi32( *buffer << 24 );
+                    c0 = _mm256_xor_si256( c0, byte );
+                    c1 = _mm256_xor_si256( c1, byte );
+                    c2 = _mm256_xor_si256( c2, byte );
+                    c3 = _mm256_xor_si256( c3, byte );
+                    for( int bit = 0; bit < 8; bit++ )
+                    {
+                        // if( crc & (1L << 31)) crc = (crc << 1) ^ POLY;
+                        c0 = _mm256_xor_si256( _mm256_slli_epi32( c0, 1 ), _mm256_and_si256( p0, _mm256_srai_epi32( c0, 31 ) ) );
+                        c1 = _mm256_xor_si256( _mm256_slli_epi32( c1, 1 ), _mm256_and_si256( p1, _mm256_srai_epi32( c1, 31 ) ) );
+                        c2 = _mm256_xor_si256( _mm256_slli_epi32( c2, 1 ), _mm256_and_si256( p2, _mm256_srai_epi32( c2, 31 ) ) );
+                        c3 = _mm256_xor_si256( _mm256_slli_epi32( c3, 1 ), _mm256_and_si256( p3, _mm256_srai_epi32( c3, 31 ) ) );
+                    }
+                }
+            }
+
+            const uint32_t mask = 0
+                | ((uint32_t) _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( c0, target ) ) ) <<  0)
+                | ((uint32_t) _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( c1, target ) ) ) <<  8)
+                | ((uint32_t) _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( c2, target ) ) ) << 16)
+                | ((uint32_t) _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( c3, target ) ) ) << 24);
+
+            for( int lane = 0; mask && (lane < 32); lane++ )
+                if ((mask >> lane) & 1)
+                    if (nHit < nHitMax)
+                        aHit[ nHit++ ] = first + (i + lane)*step;
+        }
+        return nHit;
+    }
+#endif // CPU_X86
+
+    // Solve init and xorout for the polynomial from all samples
+    // @return false if no init and xorout are consistent with the samples
+    // ========================================================================
+    bool SolveInitXorOut( const bool bReflect, const uint32_t poly, uint32_t *pInit, uint32_t *pXorOut, int *pFree )
+    {
+        // Unknowns: bits 0..31 = init, 32..63 = xorout
+        uint64_t aCoef[ MAX_SAMPLES * 32 ];
+        uint8_t  aRHS [ MAX_SAMPLES * 32 ];
+        int      nRows = 0;
+
+        for( int iSample = 0; iSample < gnSamples; iSample++ )
+        {
+            const Sample *sample = &gaSamples[ iSample ];
+            const uint32_t rhs = sample->crc ^ crc32_poly_raw( bReflect, poly, 0, sample->length, sample->data );
+
+            // Column j of Z_n is the register after n zero bytes from init = 1 << j
+            uint32_t aZ[ 32 ];
+            for( int j = 0; j < 32; j++ )
+                aZ[ j ] = crc32_poly_raw( bReflect, poly, 1u << j, sample->length, NULL );
+
+            for( int i = 0; i < 32; i++, nRows++ )
+            {
+                uint64_t coef = 1ull << (32 + i); // xorout bit i
+                for( int j = 0; j < 32; j++ )
+                    coef |= (uint64_t)((aZ[ j ] >> i) & 1) << j;
+
+                aCoef[ nRows ] = coef;
+                aRHS [ nRows ] = (rhs >> i) & 1;
+            }
+        }
+
+        // Gaussian elimination over GF(2)
+        int aPivotRow[ 64 ];
+        int rank = 0;
+        for( int col = 0; col < 64; col++ )
+        {
+            aPivotRow[ col ] = -1;
+
+            int pivot = rank;
+            while( (pivot < nRows) && !((aCoef[ pivot ] >> col) & 1) )
+                pivot++;
+            if (pivot == nRows)
+                continue;
+
+            uint64_t c = aCoef[ pivot ]; aCoef[ pivot ] = aCoef[ rank ]; aCoef[ rank ] = c;
+            uint8_t  r = aRHS [ pivot ]; aRHS [ pivot ] = aRHS [ rank ]; aRHS [ rank ] = r;
+
+            for( int row = 0; row < nRows; row++ )
+                if ((row != rank) && ((aCoef[ row ] >> col) & 1))
+                {
+                    aCoef[ row ] ^= aCoef[ rank ];
+                    aRHS [ row ] ^= aRHS [ rank ];
+                }
+
+            aPivotRow[ col ] = rank++;
+        }
+
+        for( int row = rank; row < nRows; row++ )
+            if (aRHS[ row ]) // 0 = 1
+                return false;
+
+        // Particular solution with free variables = 0
+        uint64_t solution = 0;
+        for( int col = 0; col < 64; col++ )
+            if ((aPivotRow[ col ] >= 0) && aRHS[ aPivotRow[ col ] ])
+                solution |= 1ull << col;
+
+        *pInit   = (uint32_t)(solution      );
+        *pXorOut = (uint32_t)(solution >> 32);
+        *pFree   = 64 - rank;
+        return true;
+    }
+
+    // Same-length pairs cancel init and xorout
+    // ========================================================================
+    void BuildSearchSamples()
+    {
+        gnSearch = 0;
+        for( int i = 0; i < gnSamples; i++ )
+            for( int j = 0; j < i; j++ )
+            {
+                if (gaSamples[ i ].length != gaSamples[ j ].length)
+                    continue;
+
+                // Pair each sample with the first of its length only
+                bool bFirst = true;
+                for( int k = 0; k < j; k++ )
+                    if (gaSamples[ k ].length == gaSamples[ j ].length)
+                        bFirst = false;
+                if (!bFirst || (gnSearch >= MAX_SAMPLES))
+                    continue;
+
+                Sample *diff = &gaSearch[ gnSearch++ ];
+                diff->length = gaSamples[ i ].length;
+                diff->data   = (unsigned char*) malloc( diff->length + 1 );
+                diff->crc    = gaSamples[ i ].crc ^ gaSamples[ j ].crc;
+                diff->init   = 0;
+                diff->xorout = 0;
+                for( size_t offset = 0; offset < diff->length; offset++ )
+                    diff->data[ offset ] = gaSamples[ i ].data[ offset ] ^ gaSamples[ j ].data[ offset ];
+            }
+
+        if (!gnSearch) // No pairs, assume init -1 and final ~crc
+        {
+            for( int i = 0; i < gnSamples; i++ )
+                gaSearch[ i ] = gaSamples[ i ];
+            gnSearch = gnSamples;
+        }
+
+        // Shortest sample first for the cheapest rejection
+        for( int i = 1; i < gnSearch; i++ )
+            for( int j = i; (j > 0) && (gaSearch[ j ].length < gaSearch[ j-1 ].length); j-- )
+            {
+                Sample t = gaSearch[ j ]; gaSearch[ j ] = gaSearch[ j-1 ]; gaSearch[ j-1 ] = t;
+            }
+    }
+
+    // ========================================================================
+    void PolySearch()
+    {
+        typedef int (*PolySearch_t)( const bool, const uint32_t, const uint32_t, const uint32_t, const Sample*, uint32_t*, const int );
+        PolySearch_t pSearch = PolySearch_Scalar;
+        const char  *pName   = "scalar";
+#if CPU_X86
+        if (Cpu_HasAVX2())
+        {
+            pSearch = PolySearch_AVX2;
+            pName   = "AVX2";
+        }
+#endif
+
+        const uint32_t CHUNK   = 1u << 16;   // polynomials per work item
+        const int      nChunks = 1 << 15;    // 2^31 / CHUNK per form
+
+        printf( "Searching 2^31 normal and 2^31 reflected polynomials (%s) against %d %s...\n"
+            , pName, gnSearch
+            , gaSearch[0].init ? "sample(s), assuming init -1 and final ~crc" : "same-length differential(s)" );
+
+#pragma omp parallel for schedule(dynamic)
+        for( int iItem = 0; iItem < 2*nChunks; iItem++ )
+        {
+            const bool     bReflect = iItem >= nChunks;
+            const uint32_t iChunk   = (uint32_t)(iItem % nChunks);
+
+            // Normal: odd polynomials, Reflected: bit 31 set
+            const uint32_t step  = bReflect ? 1 : 2;
+            const uint32_t first = bReflect
+                ? 0x80000000u | (iChunk * CHUNK)
+                : (iChunk * CHUNK * 2) | 1;
+
+            uint32_t aHit[ MAX_POLY_HITS ];
+            int      nHit = pSearch( bReflect, first, step, CHUNK, &gaSearch[0], aHit, MAX_POLY_HITS );
+
+            for( int iHit = 0; iHit < nHit; iHit++ )
+            {
+                bool bMatch = true;
+                for( int iSample = 1; bMatch && (iSample < gnSearch); iSample++ )
+                    bMatch = PolySample( bReflect, aHit[ iHit ], &gaSearch[ iSample ] ) == gaSearch[ iSample ].crc;
+
+                if (bMatch)
+#pragma omp critical (found)
+                {
+                    if (gnPolyFound[ bReflect ] < MAX_POLY_HITS)
+                        gaPolyFound[ bReflect ][ gnPolyFound[ bReflect ]++ ] = aHit[ iHit ];
+                }
+            }
+        }
+    }
+
+    // ========================================================================
+    void PolyRecover()
+    {
+        gnPolyFound[0] = gnPolyFound[1] = 0;
+
+        if (gnPolyGiven)
+        {
+            gaPolyFound[0][ gnPolyFound[0]++ ] = gnPolyGiven;
+            gaPolyFound[1][ gnPolyFound[1]++ ] = gnPolyGiven;
+        }
+        else
+        {
+            PROFILE_SCOPE( "search" );
+            BuildSearchSamples();
+            PolySearch();
+        }
+
+        PROFILE_SCOPE( "solve" );
+
+        int nLengths = 0;
+        for( int i = 0; i < gnSamples; i++ )
+        {
+            bool bNew = true;
+            for( int j = 0; j < i; j++ )
+                if (gaSamples[ j ].length == gaSamples[ i ].length)
+                    bNew = false;
+            nLengths += bNew;
+        }
+
+        int nMatch = 0;
+        for( int bReflect = 0; bReflect < 2; bReflect++ )
+            for( int iPoly = 0; iPoly < gnPolyFound[ bReflect ]; iPoly++ )
+            {
+                const uint32_t poly = gaPolyFound[ bReflect ][ iPoly ];
+                uint32_t init, xorout;
+                int      nFree;
+
+                if (!SolveInitXorOut( bReflect, poly, &init, &xorout, &nFree ))
+                    continue;
+
+                printf( "Poly: %08X  %s  (%s form: %08X)  Init: %08X  XorOut: %08X"
+                    , poly
+                    , bReflect ? "Reflected" : "Normal   "
+                    , bReflect ? "normal"    : "reflected"
+                    , reflect32( poly )
+                    , init
+                    , xorout
+                );
+                if (nFree)
+                    printf( "  (1 of 2^%d solutions%s)", nFree, (nLengths < 2) ? ", add a sample of a different length" : " for these lengths" );
+                printf( "\n" );
+                nMatch++;
+            }
+
+        if (!nMatch)
+            printf( "No polynomial matches all samples\n" );
+        else
+        if ((nMatch > 1) && !gnPolyGiven)
+            printf( "WARNING: %s%d polynomials match all samples, add more samples to tell them apart\n"
+                , ((gnPolyFound[0] >= MAX_POLY_HITS) || (gnPolyFound[1] >= MAX_POLY_HITS)) ? "At least " : ""
+                , nMatch );
+    }
+
+// File Identification
+//
+// Runs every CRC32Id form and named model over the file in one pass,
+// see crc32_models.h, and reports which ones give the crc.
+// The file is read in gTune.chunk blocks, see util_tune.h.
+
+    const char *gpFileName = NULL; // -f
+    uint32_t    gnFileCRC  = 0;    // -c
+    bool        gbFileCRC  = false;
+
+    // @return false if the file couldn't be read
+    // ========================================================================
+    bool FileIdentify()
+    {
+        {
+            PROFILE_SCOPE( "table init" );
+            if (Crc32Models_Init())
+                return false;
+        }
+
+        FILE *pFile = fopen( gpFileName, "rb" );
+        if (!pFile)
+        {
+            printf( "ERROR: Couldn't open file: %s\n", gpFileName );
+            return false;
+        }
+
+        const size_t   nBlock = gTune.chunk;
+        unsigned char *pBlock = (unsigned char*) malloc( nBlock );
+        uint64_t       nSize  = 0;
+        Crc32Fused     state;
+
+        Timer timer;
+        timer.Start();
+
+            Crc32Fused_Begin( &state );
+            for( size_t nRead; ; nSize += nRead )
+            {
+                {
+                    PROFILE_SCOPE( "read" );
+                    nRead = fread( pBlock, 1, nBlock, pFile );
+                }
+                if (!nRead)
+                    break;
+
+                PROFILE_SCOPE( "crc evaluation" );
+                Crc32Fused_Update( &state, nRead, pBlock );
+            }
+
+            uint32_t aFamily[ 32 ], aNamed[ nModels ];
+            Crc32Fused_End( &state, aFamily, aNamed );
+
+        timer.Stop();
+        timer.Throughput( nSize );
+
+        fclose( pFile );
+        free( pBlock );
+
+        PROFILE_SCOPE( "output" );
+        const char *aNoYes[2] = { "No ", "Yes" };
+        int nMatch = 0;
+
+        printf( "File: %s, %llu bytes, %s (%llu %cB/s)\n"
+            , gpFileName, (unsigned long long) nSize
+            , timer.data.hms, (unsigned long long) timer.throughput.per_sec, timer.throughput.prefix );
+
+        for( int iModel = 0; iModel < nModels; iModel++ )
+            if (!gbFileCRC || (aNamed[ iModel ] == gnFileCRC))
+            {
+                printf( "    0x%08X  %-18s  Poly: %08X  Reflect: %s  Init: %08X  XorOut: %08X\n"
+                    , aNamed[ iModel ]
+                    , aModels[ iModel ].name
+                    , aModels[ iModel ].poly
+                    , aNoYes[ aModels[ iModel ].reflect ]
+                    , aModels[ iModel ].init
+                    , aModels[ iModel ].xorout
+                );
+                nMatch++;
+            }
+
+        for( int id = 0; id < 32; id++ )
+            if (!gbFileCRC || (aFamily[ id ] == gnFileCRC))
+            {
+                printf( "    0x%08X  CRC32Id %2d           %s  Shift: %s, Rev. Data: %d, Rev. CRC: %d\n"
+                    , aFamily[ id ]
+                    , id
+                    , aDesc[ id >> 3 ]
+                    , ((id >> 2) & 1) ? "Right" : "Left "
+                    , (id >> 1) & 1
+                    , (id >> 0) & 1
+                );
+                nMatch++;
+            }
+
+        if (gbFileCRC && !nMatch)
+            printf( "No known CRC32 gives 0x%08X, try recovering it with samples: -s or -x\n", gnFileCRC );
+
+        return true;
+    }
+
+// Batch Identification
+//
+// Reads one record per line from a file or stdin:
+//
+//     poly hash [data]
+//
+// poly and hash are hex, poly 0 matches any polynomial, and the optional
+// data is hex bytes (spaces allowed). Without data the hash is the check
+// value of "123456789"; all check values of the CRC32Id family and the
+// named models are indexed in a hash table. With data, every CRC of the
+// data is computed in one fused pass.
+//
+// Lines starting with '#' are copied through. Each record is echoed
+// with its matches appended:
+//
+//     04C11DB7 CBF43926 = CRC32Id 3, CRC32Id 28, CRC-32/ISO-HDLC
+
+    const int MAX_BATCH_LINE = 64 * 1024;
+
+    struct CheckEntry
+    {
+        uint32_t check;
+        int16_t  id   ; // CRC32Id 0..31, or 32 + iModel, -1 = empty
+    };
+
+    const int  CHECK_BITS  = 7; // > 2x entries
+    CheckEntry gaCheckIndex[ 1 << CHECK_BITS ];
+
+    const char *gpBatchName = NULL; // -b
+    bool        gbBatch     = false;
+
+    // ========================================================================
+    inline uint32_t CheckIndex_Hash( const uint32_t check )
+    {
+        return (check * 0x9E3779B1u) >> (32 - CHECK_BITS);
+    }
+
+    // ========================================================================
+    void CheckIndex_Insert( const uint32_t check, const int id )
+    {
+        uint32_t slot = CheckIndex_Hash( check );
+        while( gaCheckIndex[ slot ].id >= 0 )
+            slot = (slot + 1) & ((1 << CHECK_BITS) - 1);
+
+        gaCheckIndex[ slot ].check = check;
+        gaCheckIndex[ slot ].id    = (int16_t) id;
+    }
+
+    // ========================================================================
+    void CheckIndex_Init()
+    {
+        for( int slot = 0; slot < (1 << CHECK_BITS); slot++ )
+            gaCheckIndex[ slot ].id = -1;
+
+        for( int id = 0; id < 32; id++ )
+            CheckIndex_Insert( CRC32Family[ id ], id );
+
+        for( int iModel = 0; iModel < nModels; iModel++ )
+            CheckIndex_Insert( aModels[ iModel ].check, 32 + iModel );
+    }
+
+    // Either form of a model's polynomial identifies it
+    // ========================================================================
+    inline bool Batch_PolyMatch( const uint32_t poly, const int id )
+    {
+        const uint32_t want = (id < 32) ? aPoly[ id >> 3 ] : aModels[ id - 32 ].poly;
+        return !poly || (poly == want) || (poly == reflect32( want ));
+    }
+
+    // ========================================================================
+    inline void Batch_Append( char **pOut, int *pMatch, const int id )
+    {
+        if (id < 32)
+            *pOut += sprintf( *pOut, "%s CRC32Id %d", *pMatch ? "," : " =", id );
+        else
+            *pOut += sprintf( *pOut, "%s %s", *pMatch ? "," : " =", aModels[ id - 32 ].name );
+        (*pMatch)++;
+    }
+
+    // @return false if the input couldn't be read
+    // ========================================================================
+    bool BatchIdentify()
+    {
+        {
+            PROFILE_SCOPE( "table init" );
+            if (Crc32Models_Init())
+                return false;
+            CheckIndex_Init();
+        }
+
+        FILE *pFile = (gpBatchName && *gpBatchName) ? fopen( gpBatchName, "rb" ) : stdin;
+        if (!pFile)
+        {
+            printf( "ERROR: Couldn't open file: %s\n", gpBatchName );
+            return false;
+        }
+
+        static char    line[ MAX_BATCH_LINE ];
+        static char    out [ MAX_BATCH_LINE + 1024 ];
+        unsigned char *data = (unsigned char*) malloc( MAX_BATCH_LINE / 2 );
+
+        static char outbuf[ 1 << 16 ];
+        setvbuf( stdout, outbuf, _IOFBF, sizeof( outbuf ) );
+
+        uint64_t nRecords = 0, nKnown = 0;
+
+        while( fgets( line, sizeof( line ), pFile ) )
+        {
+            size_t length = strlen( line );
+            while( length && ((line[ length-1 ] == '\n') || (line[ length-1 ] == '\r')) )
+                line[ --length ] = 0;
+
+            if (!length || (line[0] == '#'))
+            {
+                puts( line );
+                continue;
+            }
+
+            char    *next;
+            uint32_t poly = strtoul( line, &next, 16 );
+            uint32_t hash = strtoul( next, &next, 16 );
+
+            size_t nData = 0;
+            for( unsigned int byte; *next; )
+            {
+                if (isspace( *next )) { next++; continue; }
+                if (sscanf( next, "%2X", &byte ) != 1)
+                    break;
+                data[ nData++ ] = (unsigned char) byte;
+                next += isxdigit( next[1] ) ? 2 : 1;
+            }
+
+            char *pOut   = out;
+            int   nMatch = 0;
+            pOut += sprintf( pOut, "%s", line );
+
+            if (nData)
+            {
+                PROFILE_SCOPE( "crc evaluation" );
+                Crc32Fused state;
+                uint32_t   aFamily[ 32 ], aNamed[ nModels ];
+
+                Crc32Fused_Begin ( &state );
+                Crc32Fused_Update( &state, nData, data );
+                Crc32Fused_End   ( &state, aFamily, aNamed );
+
+                for( int id = 0; id < 32; id++ )
+                    if ((aFamily[ id ] == hash) && Batch_PolyMatch( poly, id ))
+                        Batch_Append( &pOut, &nMatch, id );
+
+                for( int iModel = 0; iModel < nModels; iModel++ )
+                    if ((aNamed[ iModel ] == hash) && Batch_PolyMatch( poly, 32 + iModel ))
+                        Batch_Append( &pOut, &nMatch, 32 + iModel );
+            }
+            else
+            {
+                for( uint32_t slot = CheckIndex_Hash( hash ); gaCheckIndex[ slot ].id >= 0; slot = (slot + 1) & ((1 << CHECK_BITS) - 1) )
+                    if ((gaCheckIndex[ slot ].check == hash) && Batch_PolyMatch( poly, gaCheckIndex[ slot ].id ))
+                        Batch_Append( &pOut, &nMatch, gaCheckIndex[ slot ].id );
+            }
+
+            if (!nMatch)
+                pOut += sprintf( pOut, " = unknown" );
+
+            puts( out );
+            nRecords++;
+            nKnown += (nMatch > 0);
+        }
+
+        fflush( stdout );
+        fprintf( stderr, "%llu records, %llu identified\n", (unsigned long long) nRecords, (unsigned long long) nKnown );
+
+        if (pFile != stdin)
+            fclose( pFile );
+        free( data );
+        return true;
+    }
+
+// Parse "data=crc", data is text or with bHex "31 32 33" or "313233"
+// @return false if there is no '=', the crc isn't hex, or bHex data isn't whole hex bytes
+// ========================================================================
+bool AddSample( const char *arg, const bool bHex )
+{
+    const char *equal = strrchr( arg, '=' );
+    if (!equal || (gnSamples >= MAX_SAMPLES))
+        return false;
+
+    char *end;
+    const uint32_t crc = strtoul( equal + 1, &end, 16 );
+    if ((end == equal + 1) || *end)
+        return false;
+
+    Sample *sample = &gaSamples[ gnSamples ];
+    size_t  length = (size_t)(equal - arg);
+
+    sample->data   = (unsigned char*) malloc( length + 1 );
+    sample->length = 0;
+    sample->crc    = crc;
+    sample->init   = 0xFFFFFFFF;
+    sample->xorout = 0xFFFFFFFF;
+
+    if (bHex)
+    {
+        // Whole bytes of 2 hex digits, optionally separated by spaces
+        for( const char *hex = arg; hex < equal; )
+        {
+            if (isspace( (unsigned char) hex[0] )) { hex++; continue; }
+            if ((hex + 1 >= equal) || !isxdigit( (unsigned char) hex[0] ) || !isxdigit( (unsigned char) hex[1] ))
+            {
+                free( sample->data );
+                return false;
+            }
+
+            unsigned int byte;
+            sscanf( hex, "%2X", &byte );
+            sample->data[ sample->length++ ] = (unsigned char) byte;
+            hex += 2;
+        }
+    }
+    else
+    {
+        memcpy( sample->data, arg, length );
+        sample->length = length;
+    }
+
+    // A duplicate would pair into an all zero differential that every polynomial matches
+    for( int i = 0; i < gnSamples; i++ )
+        if ((gaSamples[ i ].length == sample->length)
+        &&  (gaSamples[ i ].crc    == sample->crc   )
+        &&  !memcmp( gaSamples[ i ].data, sample->data, sample->length ))
+        {
+            printf( "Ignoring duplicate sample: %s\n", arg );
+            free( sample->data );
+            return true;
+        }
+
+    gnSamples++;
+    return true;
+}
+
+    bool gbLatency = false; // -H, see util_latency.h
+
+// ========================================================================
+int Usage()
+{
+    printf(
+"Identify a CRC32\n"
+"https://github.com/Michaelangel007/crc32\n"
+"\n"
+"Usage:\n"
+"    crc32id [poly] [hash]           Identify which CRC32 variant of poly generates hash for '%s'\n"
+"    crc32id [options] samples...    Recover the polynomial from (data, crc) samples\n"
+"    crc32id -b[file]                Identify 'poly hash [data]' records from file or stdin\n"
+"    crc32id -f<file> [-c<crc>]      Identify which known CRC32 of file gives crc, or list all\n"
+"\n"
+"    -?             Display usage\n"
+"    -b[file]       Batch mode, one record per line, stdin if no file\n"
+"    -c<crc>        CRC of the -f file in hex, also --crc <crc>\n"
+"    -f<file>       Compute every known CRC32 of file in one pass, also --file <file>\n"
+"    -j#            Use # threads\n"
+"    -H             Show per call latency histograms, needs -DUSE_LATENCY=1\n"
+"    -p<poly>       Skip the search and only solve init and xorout for poly in hex\n"
+"    -s<text>=<crc> Add sample of text with its crc in hex\n"
+"    -x<hex>=<crc>  Add sample of hex bytes with its crc in hex\n"
+"\n"
+"Set CRC32_PROFILE=1 to show where the time goes, see util_profile.h\n"
+"\n"
+"Examples:\n"
+"\n"
+"    ./crc32id 04C11DB7 CBF43926\n"
+"    ./crc32id -s123456789=CBF43926 \"-shello world=0D4A1185\"\n"
+"    ./crc32id -brecords.txt > identified.txt\n"
+"    ./crc32id -ffirmware.bin -c1C291CA3\n"
+"    ./crc32id --file firmware.bin --crc 1C291CA3\n"
+"    ./crc32id -p04C11DB7 -s123456789=... -s987654321=... -sabc=...\n"
+    , CRC32_CHECK_TXT );
+
+    return 0;
 }
 
 int main(int nArg, char *aArg[])
 {
     char buffer[16];
 
+    Profile_Init();
+    PROFILE_SCOPE( "crc32id" );
+
+    if ((nArg > 1) && (aArg[1][0] == '-'))
+    {
+        {
+            PROFILE_SCOPE( "table init" );
+            common_init();
+        }
+        Tune_Load();
+#if USE_OMP
+        Threads_Default();
+        gnThreadsActive = gTune.threads; // -j overrides
+#endif // USE_OMP
+
+        for( int iArg = 1; iArg < nArg; iArg++ )
+        {
+            const char *pArg = aArg[ iArg ];
+            if (pArg[0] != '-')
+                return Usage();
+            pArg++;
+
+            // Long spellings of -f and -c: --file <file> or --file=<file>
+            if (!strncmp( pArg, "-file", 5 ) || !strncmp( pArg, "-crc", 4 ))
+            {
+                const bool  bFile = pArg[1] == 'f';
+                const char *pName = pArg + (bFile ? 5 : 4);
+                const char *pVal  = NULL;
+
+                if (*pName == '=')
+                    pVal = pName + 1;
+                else
+                if (!*pName && (iArg + 1 < nArg))
+                    pVal = aArg[ ++iArg ];
+
+                if (!pVal)
+                    return Usage();
+
+                if (bFile)
+                    gpFileName = pVal;
+                else
+                {
+                    gnFileCRC = strtoul( pVal, 0, 16 );
+                    gbFileCRC = true;
+                }
+            }
+            else
+            if (*pArg == '?') return Usage();
+            else
+#if USE_OMP
+            if (*pArg == 'j')
+            {
+                int i = atoi( pArg+1 );
+                if( i > 0 )
+                    gnThreadsActive = i;
+                if( gnThreadsActive > MAX_THREADS )
+                    gnThreadsActive = MAX_THREADS;
+            }
+            else
+#endif // USE_OMP
+            if (*pArg == 'b')
+            {
+                gpBatchName = pArg+1;
+                gbBatch     = true;
+            }
+            else
+            if (*pArg == 'c')
+            {
+                gnFileCRC = strtoul( pArg+1, 0, 16 );
+                gbFileCRC = true;
+            }
+            else
+            if (*pArg == 'f')
+                gpFileName = pArg+1;
+            else
+            if (*pArg == 'H')
+                gbLatency = true;
+            else
+            if (*pArg == 'p')
+                gnPolyGiven = strtoul( pArg+1, 0, 16 );
+            else
+            if ((*pArg == 's') || (*pArg == 'x'))
+            {
+                if (!AddSample( pArg+1, *pArg == 'x' ))
+                {
+                    printf( "ERROR: Invalid sample, expected data=crc: %s\n", pArg+1 );
+                    return 1;
+                }
+            }
+            else
+                printf( "Unrecognized option: %c\n", *pArg );
+        }
+
+        if (gbBatch || gpFileName)
+        {
+            const bool bOk = gbBatch ? BatchIdentify() : FileIdentify();
+            if (gbLatency)
+                Latency_Dump( stderr ); // batch results are on stdout
+            return bOk ? 0 : 1;
+        }
+
+        if (!gnSamples)
+            return Usage();
+
+#if USE_OMP
+        Threads_Set();
+#endif // USE_OMP
+        printf( "Using: %u / %u threads\n", gnThreadsActive, gnThreadsMaximum );
+
+        Timer timer;
+        timer.Start();
+            PolyRecover();
+        timer.Stop();
+        timer.Print();
+        return 0;
+    }
+
     uint32_t poly = (nArg > 1) ? strtoul( aArg[1], 0, 16 ) : 0;
     uint32_t hash = (nArg > 2) ? strtoul( aArg[2], 0, 16 ) : 0;
     int      id;
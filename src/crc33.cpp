@@ -0,0 +1,138 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+A CRC32 is really a 33-bit polynomial, see "CRC32 or CRC33?" in the
+README. The same code computes CRCs of other widths, see crc_width.h.
+
+Compile:
+
+    g++ -O2 crc33.cpp -o crc33
+
+Usage:
+
+    crc33 [-t] [text]
+
+    text defaults to "123456789"
+
+Prints every CRC-8, CRC-16, CRC-24, CRC-32, CRC-40, and CRC-64 model in
+crc_width.h of the text. With -t each model is also timed on 1 MB, and
+reflected CRC-64 both with PCLMUL and with slicing-by-8.
+
+*/
+
+// Includes
+    #include "common.cpp"
+    #include "util_bench.h"
+    #include "crc_width.h"
+
+// Consts
+    const uint64_t TRIAL_NS  = 200000; // 0.2 ms
+    const size_t   TIME_SIZE = 1 << 20;
+    const int      TRIALS    = 9;
+
+// Vars
+    unsigned char    *gpBuffer = NULL;
+    volatile uint64_t gnSink   = 0;
+
+// Implementation
+
+    // ========================================================================
+    template<typename C>
+    void Crc33_Body( void *context, uint64_t nCalls )
+    {
+        const CrcTable<C> *table = (const CrcTable<C>*) context;
+        uint64_t           sum   = 0;
+
+        while( nCalls-- )
+            sum += Crc_Compute( table, TIME_SIZE, gpBuffer );
+        gnSink += sum;
+    }
+
+    // @return median GB/s
+    // ========================================================================
+    template<typename C>
+    double Crc33_Time( CrcTable<C> *table )
+    {
+        BenchStats     stats;
+        const uint64_t nCalls = Bench_Calibrate( Crc33_Body<C>, table, TRIAL_NS );
+        Bench_Measure( &stats, Crc33_Body<C>, table, nCalls, 1, TRIALS );
+        return TIME_SIZE / stats.median_ns;
+    }
+
+    // @return number of models whose check value doesn't match
+    // ========================================================================
+    template<typename C>
+    int Crc33_Show( const CrcModel<C> *aModel, const int nModel, const char *text, const bool bTime )
+    {
+        static CrcTable<C> table;
+        int                nBad   = 0;
+        const int          nDigit = 2 * (int) sizeof( C );
+
+        for( int iModel = 0; iModel < nModel; iModel++ )
+        {
+            const CrcModel<C> *model = &aModel[ iModel ];
+            const bool         bOk   = Crc_Init( &table, model );
+            nBad += !bOk;
+
+            printf( "%-18s  0x%0*llX%*s  %s"
+                , model->name
+                , nDigit, (unsigned long long) Crc_Compute( &table, strlen( text ), text )
+                , 16 - nDigit, ""
+                , bOk ? "check OK  " : "check FAIL"
+            );
+
+            if (bTime)
+            {
+                printf( "  %7.3f GB/s", Crc33_Time( &table ) );
+                if (table.bClmul)
+                {
+                    table.bClmul = false;
+                    printf( "  %7.3f GB/s slicing-by-8", Crc33_Time( &table ) );
+                    table.bClmul = true;
+                }
+            }
+            printf( "\n" );
+            fflush( stdout );
+        }
+        return nBad;
+    }
+
+// ========================================================================
+int main( const int nArg, const char *aArg[] )
+{
+    common_init();
+
+    const char *pText = CRC32_CHECK_TXT;
+    bool        bTime = false;
+
+    for( int iArg = 1; iArg < nArg; iArg++ )
+    {
+        if (!strcmp( aArg[ iArg ], "-t" ))
+            bTime = true;
+        else
+            pText = aArg[ iArg ];
+    }
+
+    if (bTime)
+    {
+        gpBuffer = (unsigned char*) malloc( TIME_SIZE );
+        for( size_t offset = 0; offset < TIME_SIZE; offset++ )
+            gpBuffer[ offset ] = (unsigned char)(offset * 0x9E3779B1u >> 24);
+    }
+
+    printf( "'%s' (%d)\n", pText, (int) strlen( pText ) );
+
+    int nBad = 0;
+    nBad += Crc33_Show( aCrc8Models , nCrc8Models , pText, bTime );
+    nBad += Crc33_Show( aCrc16Models, nCrc16Models, pText, bTime );
+    nBad += Crc33_Show( aCrc32Models, nCrc32Models, pText, bTime );
+    nBad += Crc33_Show( aCrc64Models, nCrc64Models, pText, bTime );
+
+    free( gpBuffer );
+    return nBad ? 1 : 0;
+}
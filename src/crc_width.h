@@ -0,0 +1,405 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+CRCs of any width from 8 to 64 bits: CRC-8, CRC-16, CRC-24, CRC-64, ...
+
+The table, slicing-by-8, and streaming code of crc32.h, generalized over
+the register type C = uint8_t, uint16_t, uint32_t, or uint64_t. Widths
+in between use the next larger type:
+
+    Reflected: the register is in the low bits, crc >> 8, as crc32_100
+    Normal   : the register is left aligned to the top of C, crc << 8, as
+               crc32_000, so every width shifts out its top byte the same
+               way. Crc_End() shifts it back down.
+
+Models are given as in the "Catalogue of parametrised CRC algorithms",
+poly in normal form, init before any reflection.
+
+Usage:
+
+    CrcTable<uint64_t> crc64;
+    Crc_Init( &crc64, &aCrc64Models[ 1 ] ); // CRC-64/XZ
+
+    uint64_t reg = Crc_Begin ( &crc64 );
+             reg = Crc_Update( &crc64, reg, len, data ); // any number of times
+    uint64_t crc = Crc_End   ( &crc64, reg );
+
+Reflected CRC-64 with PCLMUL folds 64 bytes at a time with carry-less
+multiplies instead of table lookups, see Crc64_UpdateClmul().
+
+Must include util_cpu.h first.
+
+*/
+
+// Types
+
+    // Parameters as in the "Catalogue of parametrised CRC algorithms"
+    template<typename C>
+    struct CrcModel
+    {
+        const char *name   ;
+        int         width  ; // bits, 8 .. 8*sizeof(C)
+        C           poly   ; // normal form
+        bool        reflect; // input and output
+        C           init   ;
+        C           xorout ;
+        C           check  ; // of "123456789"
+    };
+
+    template<typename C>
+    struct CrcTable
+    {
+        const CrcModel<C> *model;
+        int                shift; // Normal: register is left aligned by shift bits
+        C                  slice[8][256]; // slice[k][i] = i followed by k zero bytes
+        bool               bClmul; // Crc64_UpdateClmul()
+        uint64_t           fold[4];
+    };
+
+// Consts
+
+    const CrcModel<uint8_t> aCrc8Models[] =
+    {
+        //  Name                  Width  Poly  Ref    Init  XorOut  Check
+         { "CRC-8/SMBUS"        , 8    , 0x07, false, 0x00, 0x00  , 0xF4 }
+        ,{ "CRC-8/MAXIM-DOW"    , 8    , 0x31, true , 0x00, 0x00  , 0xA1 } // 1-Wire
+        ,{ "CRC-8/AUTOSAR"      , 8    , 0x2F, false, 0xFF, 0xFF  , 0xDF }
+    };
+
+    const CrcModel<uint16_t> aCrc16Models[] =
+    {
+        //  Name                  Width  Poly    Ref    Init    XorOut  Check
+         { "CRC-16/ARC"         , 16   , 0x8005, true , 0x0000, 0x0000, 0xBB3D }
+        ,{ "CRC-16/MODBUS"      , 16   , 0x8005, true , 0xFFFF, 0x0000, 0x4B37 }
+        ,{ "CRC-16/XMODEM"      , 16   , 0x1021, false, 0x0000, 0x0000, 0x31C3 }
+        ,{ "CRC-16/IBM-3740"    , 16   , 0x1021, false, 0xFFFF, 0x0000, 0x29B1 } // CCITT-FALSE
+        ,{ "CRC-16/KERMIT"      , 16   , 0x1021, true , 0x0000, 0x0000, 0x2189 }
+        ,{ "CRC-16/IBM-SDLC"    , 16   , 0x1021, true , 0xFFFF, 0xFFFF, 0x906E } // X-25
+    };
+
+    const CrcModel<uint32_t> aCrc32Models[] =
+    {
+        //  Name                  Width  Poly        Ref    Init        XorOut      Check
+         { "CRC-24/OPENPGP"     , 24   , 0x00864CFB, false, 0x00B704CE, 0x00000000, 0x0021CF02 }
+        ,{ "CRC-24/BLE"         , 24   , 0x0000065B, true , 0x00555555, 0x00000000, 0x00C25A56 }
+        ,{ "CRC-32/ISO-HDLC"    , 32   , 0x04C11DB7, true , 0xFFFFFFFF, 0xFFFFFFFF, 0xCBF43926 }
+        ,{ "CRC-32/BZIP2"       , 32   , 0x04C11DB7, false, 0xFFFFFFFF, 0xFFFFFFFF, 0xFC891918 }
+        ,{ "CRC-32/ISCSI"       , 32   , 0x1EDC6F41, true , 0xFFFFFFFF, 0xFFFFFFFF, 0xE3069283 }
+    };
+
+    const CrcModel<uint64_t> aCrc64Models[] =
+    {
+        //  Name                  Width  Poly                   Ref    Init                   XorOut                 Check
+         { "CRC-40/GSM"         , 40   , 0x0000000004820009ull, false, 0x0000000000000000ull, 0x000000FFFFFFFFFFull, 0x000000D4164FC646ull }
+        ,{ "CRC-64/XZ"          , 64   , 0x42F0E1EBA9EA3693ull, true , 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0x995DC9BBDF1939FAull }
+        ,{ "CRC-64/ECMA-182"    , 64   , 0x42F0E1EBA9EA3693ull, false, 0x0000000000000000ull, 0x0000000000000000ull, 0x6C40DF5F0B497347ull }
+        ,{ "CRC-64/WE"          , 64   , 0x42F0E1EBA9EA3693ull, false, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0x62EC59E3F1A4F00Aull }
+        ,{ "CRC-64/GO-ISO"      , 64   , 0x000000000000001Bull, true , 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0xB90956C775A41001ull }
+    };
+
+    const int nCrc8Models  = sizeof( aCrc8Models  ) / sizeof( aCrc8Models [0] );
+    const int nCrc16Models = sizeof( aCrc16Models ) / sizeof( aCrc16Models[0] );
+    const int nCrc32Models = sizeof( aCrc32Models ) / sizeof( aCrc32Models[0] );
+    const int nCrc64Models = sizeof( aCrc64Models ) / sizeof( aCrc64Models[0] );
+
+// Utility
+
+    // ========================================================================
+    inline uint64_t Crc_Mask( const int width )
+    {
+        return (width >= 64) ? ~0ull : ((1ull << width) - 1);
+    }
+
+    // Reverse the low width bits
+    // ========================================================================
+    inline uint64_t Crc_Reflect( const uint64_t x, const int width )
+    {
+        return reverse64( x ) >> (64 - width);
+    }
+
+    // ========================================================================
+    inline uint64_t Crc_Load64Le( const unsigned char *p )
+    {
+        return ((uint64_t) p[0] <<  0) | ((uint64_t) p[1] <<  8) | ((uint64_t) p[2] << 16) | ((uint64_t) p[3] << 24)
+             | ((uint64_t) p[4] << 32) | ((uint64_t) p[5] << 40) | ((uint64_t) p[6] << 48) | ((uint64_t) p[7] << 56);
+    }
+
+    // ========================================================================
+    inline uint64_t Crc_Load64Be( const unsigned char *p )
+    {
+        return ((uint64_t) p[0] << 56) | ((uint64_t) p[1] << 48) | ((uint64_t) p[2] << 40) | ((uint64_t) p[3] << 32)
+             | ((uint64_t) p[4] << 24) | ((uint64_t) p[5] << 16) | ((uint64_t) p[6] <<  8) | ((uint64_t) p[7] <<  0);
+    }
+
+    // x^n mod poly, in normal form
+    // ========================================================================
+    uint64_t Crc_PowMod( const uint64_t poly, const int width, int n )
+    {
+        const uint64_t top = 1ull << (width - 1);
+        uint64_t       rem = 1;
+
+        while( n-- )
+            rem = ((rem & top) ? (rem << 1) ^ poly : (rem << 1)) & Crc_Mask( width );
+        return rem;
+    }
+
+// Formula
+
+    // Bit at a time, straight from the model, for checking the tables
+    // ========================================================================
+    template<typename C>
+    C Crc_Formula( const CrcModel<C> *model, size_t len, const void *data )
+    {
+        const unsigned char *buffer = (const unsigned char*) data;
+        const uint64_t       top    = 1ull << (model->width - 1);
+        uint64_t             crc    = model->init;
+
+        while( len-- )
+        {
+            const uint64_t byte = model->reflect ? REVERSE_BITS[ *buffer++ ] : *buffer++;
+            crc ^= byte << (model->width - 8);
+
+            for( int bit = 0; bit < 8; bit++ )
+                crc = ((crc & top) ? (crc << 1) ^ model->poly : (crc << 1)) & Crc_Mask( model->width );
+        }
+
+        if (model->reflect)
+            crc = Crc_Reflect( crc, model->width );
+        return (C)(crc ^ model->xorout);
+    }
+
+// Table
+
+    // Byte at a time, continues a register, no init or final xor
+    // ========================================================================
+    template<typename C>
+    C Crc_UpdateByte( const CrcTable<C> *table, C crc, size_t len, const void *data )
+    {
+        const unsigned char *buffer = (const unsigned char*) data;
+        const int            BITS   = 8 * sizeof( C );
+
+        if (table->model->reflect)
+            while( len-- )
+                crc = table->slice[0][ (crc ^ *buffer++) & 0xFF ] ^ (C)((uint64_t) crc >> 8);
+        else
+            while( len-- )
+                crc = table->slice[0][ ((crc >> (BITS - 8)) ^ *buffer++) & 0xFF ] ^ (C)((uint64_t) crc << 8);
+        return crc;
+    }
+
+    // Slicing-by-8, 8 bytes are read as one 64-bit word: little endian into
+    // the low bytes of a reflected register, big endian into the top bytes
+    // of a normal one. Registers narrower than 8 bytes leave the rest of
+    // the word as data, which is looked up without waiting on the register.
+    // ========================================================================
+    template<typename C>
+    C Crc_UpdateSlice8( const CrcTable<C> *table, C crc, size_t len, const void *data )
+    {
+        const unsigned char *buffer = (const unsigned char*) data;
+        const int            BYTES  = (int) sizeof( C );
+        const C            (*T)[256] = table->slice;
+
+        if (table->model->reflect)
+        {
+            for( ; len >= 8; len -= 8, buffer += 8 )
+            {
+                const uint64_t word = Crc_Load64Le( buffer );
+                const uint64_t one  = word ^ (uint64_t) crc;
+                const uint64_t hi   = (BYTES > 4) ? one : word;
+
+                const C two = T[3][ (hi  >> 32) & 0xFF ] ^ T[2][ (hi  >> 40) & 0xFF ] ^ T[1][ (hi  >> 48) & 0xFF ] ^ T[0][ hi >> 56 ];
+                crc = (C)(two
+                    ^ (T[7][ (one >>  0) & 0xFF ] ^ T[6][ (((BYTES > 1) ? one : word) >>  8) & 0xFF ])
+                    ^ (T[5][ (((BYTES > 2) ? one : word) >> 16) & 0xFF ] ^ T[4][ (((BYTES > 3) ? one : word) >> 24) & 0xFF ]) );
+            }
+        }
+        else
+        {
+            for( ; len >= 8; len -= 8, buffer += 8 )
+            {
+                const uint64_t word = Crc_Load64Be( buffer );
+                const uint64_t one  = word ^ ((uint64_t) crc << (64 - 8*BYTES));
+                const uint64_t lo   = (BYTES > 4) ? one : word;
+
+                const C two = T[3][ (lo  >> 24) & 0xFF ] ^ T[2][ (lo  >> 16) & 0xFF ] ^ T[1][ (lo  >>  8) & 0xFF ] ^ T[0][ lo & 0xFF ];
+                crc = (C)(two
+                    ^ (T[7][ one >> 56 ] ^ T[6][ (((BYTES > 1) ? one : word) >> 48) & 0xFF ])
+                    ^ (T[5][ (((BYTES > 2) ? one : word) >> 40) & 0xFF ] ^ T[4][ (((BYTES > 3) ? one : word) >> 32) & 0xFF ]) );
+            }
+        }
+
+        return Crc_UpdateByte( table, crc, len, buffer );
+    }
+
+// Clmul
+
+#if CPU_X86
+    // Fold a 128-bit lane forward by the distance of k: the low 64 bits, the
+    // first 8 bytes, times k.low, the high 64 bits times k.high
+    // ========================================================================
+    TARGET_PCLMUL
+    inline __m128i Crc64_Fold( const __m128i x, const __m128i k )
+    {
+        return _mm_xor_si128( _mm_clmulepi64_si128( x, k, 0x00 ), _mm_clmulepi64_si128( x, k, 0x11 ) );
+    }
+
+    /*
+        Reflected CRC-64: bit j of a 128-bit lane is x^(127-j), so the lane
+        is H*x^64 + L with H the first 8 bytes. Moving the lane d bits
+        forward is H*x^(d+64) + L*x^d mod P. The carry-less product of two
+        reflected 64-bit values comes out one bit short, times x, so the
+        constants are x^(d+63) and x^(d-1) mod P:
+
+            fold[0], fold[1]: d = 512, 4 lanes of 16 bytes
+            fold[2], fold[3]: d = 128, the next lane
+
+        The last lane is 16 bytes of message, so the table finishes it.
+    */
+    // ========================================================================
+    TARGET_PCLMUL
+    uint64_t Crc64_UpdateClmul( const CrcTable<uint64_t> *table, uint64_t crc, size_t len, const void *data )
+    {
+        const unsigned char *buffer = (const unsigned char*) data;
+        if (len < 64)
+            return Crc_UpdateSlice8( table, crc, len, buffer );
+
+        const __m128i k512 = _mm_set_epi64x( (int64_t) table->fold[1], (int64_t) table->fold[0] );
+        const __m128i k128 = _mm_set_epi64x( (int64_t) table->fold[3], (int64_t) table->fold[2] );
+
+        __m128i x0 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*)(buffer +  0) ), _mm_set_epi64x( 0, (int64_t) crc ) );
+        __m128i x1 =                _mm_loadu_si128( (const __m128i*)(buffer + 16) );
+        __m128i x2 =                _mm_loadu_si128( (const __m128i*)(buffer + 32) );
+        __m128i x3 =                _mm_loadu_si128( (const __m128i*)(buffer + 48) );
+
+        for( buffer += 64, len -= 64; len >= 64; buffer += 64, len -= 64 )
+        {
+            x0 = _mm_xor_si128( Crc64_Fold( x0, k512 ), _mm_loadu_si128( (const __m128i*)(buffer +  0) ) );
+            x1 = _mm_xor_si128( Crc64_Fold( x1, k512 ), _mm_loadu_si128( (const __m128i*)(buffer + 16) ) );
+            x2 = _mm_xor_si128( Crc64_Fold( x2, k512 ), _mm_loadu_si128( (const __m128i*)(buffer + 32) ) );
+            x3 = _mm_xor_si128( Crc64_Fold( x3, k512 ), _mm_loadu_si128( (const __m128i*)(buffer + 48) ) );
+        }
+
+        __m128i x = _mm_xor_si128( Crc64_Fold( x0, k128 ), x1 );
+        x = _mm_xor_si128( Crc64_Fold( x, k128 ), x2 );
+        x = _mm_xor_si128( Crc64_Fold( x, k128 ), x3 );
+
+        for( ; len >= 16; buffer += 16, len -= 16 )
+            x = _mm_xor_si128( Crc64_Fold( x, k128 ), _mm_loadu_si128( (const __m128i*) buffer ) );
+
+        unsigned char last[ 16 ];
+        _mm_storeu_si128( (__m128i*) last, x );
+
+        crc = Crc_UpdateSlice8( table, (uint64_t) 0, sizeof( last ), last );
+        return Crc_UpdateSlice8( table, crc, len, buffer );
+    }
+#endif // CPU_X86
+
+// Streaming
+
+    // ========================================================================
+    template<typename C>
+    inline C Crc_Update( const CrcTable<C> *table, C crc, size_t len, const void *data )
+    {
+        return Crc_UpdateSlice8( table, crc, len, data );
+    }
+
+    // ========================================================================
+    inline uint64_t Crc_Update( const CrcTable<uint64_t> *table, uint64_t crc, size_t len, const void *data )
+    {
+#if CPU_X86
+        if (table->bClmul)
+            return Crc64_UpdateClmul( table, crc, len, data );
+#endif
+        return Crc_UpdateSlice8( table, crc, len, data );
+    }
+
+    // @return register with init, to pass to Crc_Update()
+    // ========================================================================
+    template<typename C>
+    inline C Crc_Begin( const CrcTable<C> *table )
+    {
+        const CrcModel<C> *model = table->model;
+        return model->reflect
+            ? (C) Crc_Reflect( model->init, model->width )
+            : (C)((uint64_t) model->init << table->shift);
+    }
+
+    // @return finished CRC of the register
+    // ========================================================================
+    template<typename C>
+    inline C Crc_End( const CrcTable<C> *table, const C crc )
+    {
+        const CrcModel<C> *model = table->model;
+        return model->reflect
+            ? (C)(crc ^ model->xorout)
+            : (C)(((uint64_t) crc >> table->shift) ^ model->xorout);
+    }
+
+    // ========================================================================
+    template<typename C>
+    inline C Crc_Compute( const CrcTable<C> *table, size_t len, const void *data )
+    {
+        return Crc_End( table, Crc_Update( table, Crc_Begin( table ), len, data ) );
+    }
+
+// Init
+
+    // @param bClmul - use PCLMUL if the model and CPU can
+    // @return true if the check value matches
+    // ========================================================================
+    template<typename C>
+    bool Crc_Init( CrcTable<C> *table, const CrcModel<C> *model, const bool bClmul = true )
+    {
+        const int BITS = 8 * sizeof( C );
+
+        table->model  = model;
+        table->shift  = BITS - model->width;
+        table->bClmul = false;
+
+        if (model->reflect)
+        {
+            const uint64_t poly = Crc_Reflect( model->poly, model->width );
+            for( int byte = 0; byte < 256; byte++ )
+            {
+                uint64_t crc = (uint64_t) byte;
+                for( int bit = 0; bit < 8; bit++ )
+                    crc = (crc & 1) ? (crc >> 1) ^ poly : (crc >> 1);
+                table->slice[0][ byte ] = (C) crc;
+            }
+
+            for( int slice = 1; slice < 8; slice++ )
+                for( int byte = 0; byte < 256; byte++ )
+                    table->slice[ slice ][ byte ] = table->slice[0][ table->slice[ slice-1 ][ byte ] & 0xFF ] ^ (C)((uint64_t) table->slice[ slice-1 ][ byte ] >> 8);
+        }
+        else
+        {
+            const uint64_t poly = (uint64_t) model->poly << table->shift;
+            const uint64_t top  = 1ull << (BITS - 1);
+            for( int byte = 0; byte < 256; byte++ )
+            {
+                uint64_t crc = (uint64_t) byte << (BITS - 8);
+                for( int bit = 0; bit < 8; bit++ )
+                    crc = ((crc & top) ? (crc << 1) ^ poly : (crc << 1)) & Crc_Mask( BITS );
+                table->slice[0][ byte ] = (C) crc;
+            }
+
+            for( int slice = 1; slice < 8; slice++ )
+                for( int byte = 0; byte < 256; byte++ )
+                    table->slice[ slice ][ byte ] = table->slice[0][ table->slice[ slice-1 ][ byte ] >> (BITS - 8) ] ^ (C)((uint64_t) table->slice[ slice-1 ][ byte ] << 8);
+        }
+
+        if (model->reflect && (model->width == 64))
+        {
+            const int aDistance[4] = { 512 + 63, 512 - 1, 128 + 63, 128 - 1 };
+            for( int iFold = 0; iFold < 4; iFold++ )
+                table->fold[ iFold ] = reverse64( Crc_PowMod( model->poly, 64, aDistance[ iFold ] ) );
+            table->bClmul = bClmul && Cpu_HasPCLMUL();
+        }
+
+        return Crc_Compute( table, strlen( CRC32_CHECK_TXT ), CRC32_CHECK_TXT ) == model->check;
+    }
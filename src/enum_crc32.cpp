@@ -12,7 +12,8 @@ http://stackoverflow.com/questions/26049150/calculate-a-32-bit-crc-lookup-table-
 */
 
 // Includes
-    #include "common.h"
+    #include "common.cpp"
+    #include "crc32_rewrite.h"
 
 // ========================================================================
 int main()
@@ -22,6 +23,7 @@ int main()
     const char   *text   = CRC32_CHECK_TXT;
     const size_t  length = strlen( text );
     uint32_t      CRC32A = 0xFC891918;
+    static Crc32Rewrite rewrite;
 
     common_init();
 
@@ -52,7 +54,9 @@ int main()
             int isRevCRC  = (iFunc >> 0) & 1;
 
             crc = aFunc[ iFunc ]( pData, length, text ); 
-            printf( "   Shift: %s, Rev. Data: %d, Rev. CRC: %d, 0x%08X  %s\n"
+            Crc32Rewrite_Init( &rewrite, pData, iFunc );
+
+            printf( "   Shift: %s, Rev. Data: %d, Rev. CRC: %d, 0x%08X  %-6s  = %s %s%s%s\n"
                 , isShiftR
                   ? "Right"
                   : "Left "
@@ -64,6 +68,10 @@ int main()
                     : crc == CRC32A
                         ? "crc32a"
                         : "no"
+                , rewrite.bRight ? "right" : "left "
+                , gaRewriteKernel[ rewrite.kernel ]
+                , rewrite.bReverse ? ", reversed" : ""
+                , (Crc32Rewrite_Crc( &rewrite, length, text ) == crc) ? "" : "  MISMATCH"
             );
         }
 
@@ -0,0 +1,586 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Parallel collision search with distinguished points (van Oorschot-Wiener)
+for pairs of inputs of the same length, restricted to a character set,
+that have the same CRC32.
+
+    f( x ) = CRC32( Encode( x ) )
+
+Encode() maps a 32-bit x to a string: the base |C| digits of x, padded
+with chars chosen per version of f. Each thread walks x, f(x), f(f(x)), ...
+from a random start until x is distinguished (low D bits zero), then
+stores (x, start, length) in a bounded hash table. Two walks that reach
+the same distinguished point from different starts have merged, so
+re-walking both from the same distance finds a, b with f(a) == f(b).
+
+Expected work is ~sqrt(pi * 2^32 / 2) = 82,000 CRCs per collision with
+memory bounded by -M, instead of 2^32 of either time or memory.
+
+With fewer than 2^32 inputs N, e.g. 8 digits, the digits are of
+(x ^ key) mod N, with a key per version. Walks then also merge on two x
+that are the same input, which are skipped like Robin Hoods, so only
+about N / 2^32 of the merges are collisions:
+
+    ./collide -sd -l8 -k1
+
+Some small input spaces have no collisions at all, e.g. 6 lowercase
+letters, see DifferenceRank().
+
+Every version is only seen through its own copy, taken under the points
+lock, so a thread still walking an old version never sees a new pad.
+
+*/
+
+// Defines
+    #define USE_OMP 1
+#if _WIN32
+    #define _CRT_SECURE_NO_WARNINGS 1
+#endif
+
+// Includes
+    #include <math.h> // sqrt(), log2()
+    #include <time.h> // time()
+    #include "common.cpp"
+
+// BEGIN OMP
+#if USE_OMP
+    #include <omp.h>
+#endif
+    #include "util_threads.h"
+    #include "util_timer.h"
+// END OMP
+    #include "charset.h"
+
+// Consts
+    const int MAX_LENGTH = 64;
+
+// Types
+    // One function f, see NewVersion()
+    struct Version
+    {
+        uint32_t id ;
+        uint32_t key;
+        uint8_t  pad[ MAX_LENGTH ]; // positions past the digits
+    };
+
+    struct Point
+    {
+        uint32_t dp    ; // distinguished point
+        uint32_t start ;
+        uint32_t length; // 0 = empty
+    };
+
+// Vars
+    const uint32_t *gpTable      = CRC32_REVERSE;
+    char            cSearchCRC32 = 'b';
+
+    Charset         gCharset;
+    int             gnLength     = 8;
+    int             gnDigits     = 0; // positions needed for 32-bit x
+    uint32_t        gnInputs     = 0; // inputs when fewer than 2^32, else 0
+
+    uint64_t        gnWanted     = 10;
+    uint64_t        gnFound      = 0;
+    uint64_t        gnRobinHood  = 0; // walk started on another walk, or x mod N aliased
+    uint64_t        gnSteps      = 0;
+    uint64_t        gnErrors     = 0; // reported pairs that don't collide
+    volatile bool   gbDone       = false;
+    size_t          gnMemoryMB   = 64;
+    int             gnDistinguishedBits = -1; // -1 = auto
+
+    Point          *gaPoints     = NULL;
+    uint32_t        gnPointBits  = 0;
+    uint32_t        gnPointMask  = 0;
+    uint32_t        gnPoints     = 0;
+    Version         gVersion;         // current, only used in critical (points)
+
+    uint32_t       *gaFound      = NULL; // (version, a, b) inputs with a < b for de-duplication
+
+// Function
+
+    // @return the input x stands for in version f
+    // ========================================================================
+    inline uint32_t Input( const Version *f, const uint32_t x )
+    {
+        const uint32_t value = x ^ f->key;
+        return gnInputs ? value % gnInputs : value;
+    }
+
+    // ========================================================================
+    inline void Encode( const Version *f, const uint32_t x, uint8_t *data )
+    {
+        uint32_t value = Input( f, x );
+        memcpy( data, f->pad, gnLength );
+        for( int offset = 0; offset < gnDigits; offset++ )
+        {
+            data[ offset ] = gCharset.chars[ value % gCharset.count ];
+            value /= gCharset.count;
+        }
+    }
+
+    // ========================================================================
+    inline uint32_t Step( const Version *f, const uint32_t x )
+    {
+        uint8_t data[ MAX_LENGTH ];
+        Encode( f, x, data );
+        return crc32_100( gpTable, gnLength, data );
+    }
+
+    // xorshift32
+    // ========================================================================
+    inline uint32_t Random( uint32_t *seed )
+    {
+        uint32_t x = *seed;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x <<  5;
+        return *seed = x;
+    }
+
+    // New version of f: new padding and key, and an empty table
+    // Call in critical (points)
+    // ========================================================================
+    void NewVersion( uint32_t *seed )
+    {
+        for( int offset = gnDigits; offset < gnLength; offset++ )
+            gVersion.pad[ offset ] = gCharset.chars[ Random( seed ) % gCharset.count ];
+        gVersion.key = Random( seed );
+        gVersion.id++;
+
+        memset( gaPoints, 0, sizeof( Point ) << gnPointBits );
+        gnPoints = 0;
+    }
+
+    // CRC32 is affine, crc( a ) ^ crc( b ) = L( a ^ b ), so inputs only
+    // collide on a difference in the kernel of L. Differences of chars in
+    // the charset span a few bits per position; if L is one-to-one on
+    // their span, i.e. 26 lowercase letters only differ in the low 5 bits
+    // and 6 positions are 30 bits, no two inputs collide at all.
+    // @return rank of L on the differences, at most 32
+    // @param pDim - dimension of the differences
+    // ========================================================================
+    int DifferenceRank( int *pDim )
+    {
+        uint8_t  zero[ MAX_LENGTH ] = { 0 };
+        uint8_t  data[ MAX_LENGTH ];
+        uint32_t aBasis[ 32 ]; // by top bit
+        int      rank = 0;
+
+        memset( aBasis, 0, sizeof( aBasis ) );
+        *pDim = 0;
+
+        // Span of chars[ i ] ^ chars[ 0 ], the same at every position
+        uint8_t aSpan[ 8 ]; // descending, so by top bit
+        int     nSpan = 0;
+        for( int i = 1; i < gCharset.count; i++ )
+        {
+            uint8_t d = gCharset.chars[ i ] ^ gCharset.chars[ 0 ];
+            for( int j = 0; j < nSpan; j++ )
+                if ((d ^ aSpan[ j ]) < d)
+                    d ^= aSpan[ j ];
+            if (!d)
+                continue;
+
+            aSpan[ nSpan++ ] = d;
+            for( int j = nSpan - 1; (j > 0) && (aSpan[ j ] > aSpan[ j-1 ]); j-- )
+            {
+                const uint8_t t = aSpan[ j ]; aSpan[ j ] = aSpan[ j-1 ]; aSpan[ j-1 ] = t;
+            }
+        }
+
+        const uint32_t crc0 = crc32_100( gpTable, gnLength, zero );
+        for( int offset = 0; offset < gnLength; offset++ )
+        {
+            *pDim += nSpan;
+            for( int j = 0; j < nSpan; j++ )
+            {
+                memset( data, 0, gnLength );
+                data[ offset ] = aSpan[ j ];
+
+                uint32_t v = crc32_100( gpTable, gnLength, data ) ^ crc0;
+                for( int bit = 31; (bit >= 0) && v; bit-- )
+                    if ((v >> bit) & 1)
+                    {
+                        if (!aBasis[ bit ])
+                        {
+                            aBasis[ bit ] = v;
+                            rank++;
+                            break;
+                        }
+                        v ^= aBasis[ bit ];
+                    }
+            }
+        }
+        return rank;
+    }
+
+// Search
+
+    // Both walks end at the same distinguished point.
+    // @return true if found a, b of different inputs with f(a) == f(b)
+    // ========================================================================
+    bool Locate( const Version *f, uint32_t a, uint32_t lenA, uint32_t b, uint32_t lenB, uint32_t *pA, uint32_t *pB )
+    {
+        while( lenA > lenB ) { a = Step( f, a ); lenA--; }
+        while( lenB > lenA ) { b = Step( f, b ); lenB--; }
+
+        if (a == b)
+            return false; // Robin Hood: one walk started on the other
+
+        while( lenA-- )
+        {
+            const uint32_t nextA = Step( f, a );
+            const uint32_t nextB = Step( f, b );
+            if (nextA == nextB)
+            {
+                if (Input( f, a ) == Input( f, b ))
+                    return false; // the same input, x mod N aliased
+
+                *pA = a;
+                *pB = b;
+                return true;
+            }
+            a = nextA;
+            b = nextB;
+        }
+        return false;
+    }
+
+    // @return false if the inputs are the same or their CRCs differ
+    // ========================================================================
+    bool Report( const Version *f, uint32_t a, uint32_t b )
+    {
+        uint8_t data[2][ MAX_LENGTH ];
+        char    text[2][ MAX_LENGTH + 1 ];
+
+        Encode( f, a, data[0] );
+        Encode( f, b, data[1] );
+
+        for( int i = 0; i < 2; i++ )
+        {
+            for( int offset = 0; offset < gnLength; offset++ )
+                text[i][ offset ] = ((data[i][ offset ] < 0x20) || (data[i][ offset ] >= 0x7F)) ? '.' : (char) data[i][ offset ];
+            text[i][ gnLength ] = 0;
+        }
+
+        const uint32_t crcA = crc32_100( gpTable, gnLength, data[0] );
+        const uint32_t crcB = crc32_100( gpTable, gnLength, data[1] );
+
+        const bool bSame = !memcmp( data[0], data[1], gnLength );
+
+        printf( "CRC32%c( \"%s\" ) = CRC32%c( \"%s\" ) = %08X", cSearchCRC32, text[0], cSearchCRC32, text[1], crcA );
+        if (crcA != crcB)
+            printf( " ERROR: %08X != %08X!", crcA, crcB );
+        if (bSame)
+            printf( " ERROR: Same input!" );
+        printf( "\n" );
+
+        return (crcA == crcB) && !bSame;
+    }
+
+    // ========================================================================
+    void Search()
+    {
+        // Table of w points, 50% load
+        const uint64_t nSlots = ((uint64_t)gnMemoryMB << 20) / sizeof( Point );
+
+        gnPointBits = 1;
+        while( (2ull << gnPointBits) <= nSlots )
+            gnPointBits++;
+        gnPointMask = (1u << gnPointBits) - 1;
+
+        const uint32_t nPointsMax = 1u << (gnPointBits - 1);
+
+        // Optimal fraction of distinguished points theta ~= 2.25 * sqrt( w / n )
+        if (gnDistinguishedBits < 0)
+        {
+            const double n     = gnInputs ? (double) gnInputs : 4294967296.0;
+            const double theta = 2.25 * sqrt( (double) nPointsMax / n );
+            gnDistinguishedBits = (theta >= 1.0) ? 0 : (int) floor( log2( 1.0 / theta ) + 0.5 );
+        }
+
+        const uint32_t maskDP   = (1u << gnDistinguishedBits) - 1;
+        const uint32_t maxWalk  = 20u << gnDistinguishedBits; // abandon walks stuck in a cycle
+
+        gaPoints = (Point*) calloc( (size_t)1 << gnPointBits, sizeof( Point ) );
+        gaFound  = (uint32_t*) malloc( (size_t)(3 * gnWanted + 3) * sizeof( uint32_t ) );
+        if (!gaPoints || !gaFound)
+        {
+            printf( "ERROR: Couldn't allocate point table, try a smaller -M\n" );
+            return;
+        }
+
+        printf( "// Length %d, charset %d chars, %d distinguished bits, %u points in %u slots\n"
+            , gnLength, gCharset.count, gnDistinguishedBits, nPointsMax, 1u << gnPointBits );
+
+        uint32_t seed = (uint32_t) time( NULL ) | 1;
+        gVersion.id = 0;
+        NewVersion( &seed );
+
+#pragma omp parallel
+        {
+#if USE_OMP
+            const int iThread = omp_get_thread_num(); // Get Thread Index: 0 .. nCores-1
+#else
+            const int iThread = 0;
+#endif
+            uint32_t random = (seed ^ (0x9E3779B9u * (iThread + 1))) | 1;
+            uint64_t steps  = 0;
+            Version  f;
+
+            while( !gbDone )
+            {
+#pragma omp critical (points)
+                f = gVersion;
+
+                const uint32_t start   = Random( &random );
+                      uint32_t x       = start;
+                      uint32_t length  = 0;
+
+                while( (x & maskDP) && (length < maxWalk) )
+                {
+                    x = Step( &f, x );
+                    length++;
+                }
+                steps += length;
+
+                if ((x & maskDP) || !length)
+                    continue;
+
+                // Insert, or find the walk that got here first
+                Point other = { 0, 0, 0 };
+#pragma omp critical (points)
+                {
+                    if (f.id == gVersion.id)
+                    {
+                        uint32_t slot = (x * 0x9E3779B1u) >> (32 - gnPointBits);
+                        while( gaPoints[ slot ].length && (gaPoints[ slot ].dp != x) )
+                            slot = (slot + 1) & gnPointMask;
+
+                        if (gaPoints[ slot ].length)
+                            other = gaPoints[ slot ];
+                        else
+                        {
+                            Point point = { x, start, length };
+                            gaPoints[ slot ] = point;
+                            if (++gnPoints >= nPointsMax)
+                                NewVersion( &seed );
+                        }
+                    }
+                }
+
+                if (!other.length || (other.start == start))
+                    continue;
+
+                uint32_t a, b;
+                if (!Locate( &f, start, length, other.start, other.length, &a, &b ))
+                {
+#pragma omp atomic
+                    gnRobinHood++;
+                    continue;
+                }
+
+                // Without padding every version has the same inputs
+                const uint32_t version = (gnDigits < gnLength) ? f.id : 0;
+                      uint32_t inputA  = Input( &f, a );
+                      uint32_t inputB  = Input( &f, b );
+                if (inputA > inputB) { uint32_t t = inputA; inputA = inputB; inputB = t; }
+
+#pragma omp critical (found)
+                {
+                    bool bNew = !gbDone;
+                    for( uint64_t i = 0; bNew && (i < gnFound); i++ )
+                        if ((gaFound[ 3*i+0 ] == version) && (gaFound[ 3*i+1 ] == inputA) && (gaFound[ 3*i+2 ] == inputB))
+                            bNew = false;
+
+                    if (bNew)
+                    {
+                        gaFound[ 3*gnFound+0 ] = version;
+                        gaFound[ 3*gnFound+1 ] = inputA;
+                        gaFound[ 3*gnFound+2 ] = inputB;
+                        if (!Report( &f, a, b ))
+                            gnErrors++;
+                        if (++gnFound >= gnWanted)
+                            gbDone = true;
+                    }
+                }
+            }
+
+#pragma omp atomic
+            gnSteps += steps;
+        }
+
+        free( gaPoints );
+        free( gaFound  );
+        gaPoints = NULL;
+        gaFound  = NULL;
+
+        printf( "// Found %llu collisions, %llu CRCs, %u versions, %llu Robin Hoods%s\n"
+            , (unsigned long long) gnFound, (unsigned long long) gnSteps, gVersion.id, (unsigned long long) gnRobinHood
+            , gnInputs ? " or aliases" : "" );
+    }
+
+// ========================================================================
+int Usage()
+{
+    printf(
+"Find CRC32 collisions with a parallel distinguished point search\n"
+"https://github.com/Michaelangel007/crc32\n"
+"\n"
+"Usage: collide [options]\n"
+"    -?   Display usage\n"
+"    -b   Use CRC32B (default)\n"
+"    -c   Use CRC32C\n"
+"    -D#  Distinguished point bits (default: auto from -M)\n"
+"    -j#  Use # threads\n"
+"    -k#  Stop after finding # collisions (default 10)\n"
+"    -l#  Input length (default 8)\n"
+"    -M#  Memory for distinguished points in MB (default 64)\n"
+"    -s<classes>  Character set, union of classes (default lud)\n"
+"         l = a-z, u = A-Z, d = 0-9, h = 0-9a-f, H = 0-9A-F\n"
+"         s = symbols, a = printable, b = all bytes\n"
+"\n"
+"Examples:\n"
+"\n"
+"Find 10 pairs of 8 char alphanumeric inputs with the same CRC32B\n"
+"    ./collide\n"
+"Find 100 pairs of 12 lowercase inputs with the same CRC32C\n"
+"    ./collide -c -sl -l12 -k100\n"
+"Find a pair of 8 digit inputs, 10^8 < 2^32, with the same CRC32B\n"
+"    ./collide -sd -l8 -k1\n"
+    );
+
+    return 0;
+}
+
+// ========================================================================
+int main(int nArg, char *aArg[])
+{
+    common_init( false );
+
+    Charset_Parse( &gCharset, "lud" );
+
+#if USE_OMP
+    Threads_Default();
+#endif // USE_OMP
+
+    for( int iArg = 1; iArg < nArg; iArg++ )
+    {
+        char *pArg = aArg[ iArg ];
+        if (pArg[0] != '-')
+            return Usage();
+
+        pArg++; // point to 1st char in option
+
+        if (*pArg == '?') return Usage();
+        if (*pArg == 'b')
+        {
+            cSearchCRC32 = 'b';
+            gpTable      = CRC32_REVERSE;
+        }
+        else
+        if (*pArg == 'c')
+        {
+            cSearchCRC32 = 'c';
+            gpTable      = CRC32C_REVERSED;
+        }
+        else
+        if (*pArg == 'D')
+            gnDistinguishedBits = atoi( pArg+1 );
+        else
+#if USE_OMP
+        if( *pArg == 'j' )
+        {
+            int i = atoi( pArg+1 );
+            if( i > 0 )
+                gnThreadsActive = i;
+            if( gnThreadsActive > MAX_THREADS )
+                gnThreadsActive = MAX_THREADS;
+        }
+        else
+#endif // USE_OMP
+        if (*pArg == 'k')
+        {
+            gnWanted = strtoull( pArg+1, NULL, 10 );
+            if (!gnWanted)
+                gnWanted = 1;
+        }
+        else
+        if (*pArg == 'l')
+        {
+            gnLength = atoi( pArg+1 );
+            if ((gnLength < 1) || (gnLength > MAX_LENGTH))
+            {
+                printf( "ERROR: Length must be 1..%d\n", MAX_LENGTH );
+                return 1;
+            }
+        }
+        else
+        if (*pArg == 'M')
+        {
+            int mb = atoi( pArg+1 );
+            if (mb > 0)
+                gnMemoryMB = mb;
+        }
+        else
+        if (*pArg == 's')
+        {
+            if (!Charset_Parse( &gCharset, pArg+1 ))
+            {
+                printf( "ERROR: Unknown character class in: %s\n", pArg+1 );
+                return 1;
+            }
+        }
+        else
+            printf( "Unrecognized option: %c\n", *pArg );
+    }
+
+    int nDim;
+    const int rank = DifferenceRank( &nDim );
+    if (rank == nDim)
+    {
+        printf( "ERROR: CRC32%c is one-to-one on inputs of length %d of this charset, no two collide. Use a longer length or larger charset.\n"
+            , cSearchCRC32, gnLength );
+        return 1;
+    }
+
+    // Encode() is one-to-one on 32-bit x, or x mod the inputs if fewer
+    uint64_t range = 1;
+    gnDigits = 0;
+    while( (range < 0x100000000ull) && (gnDigits < gnLength) )
+    {
+        range *= gCharset.count;
+        gnDigits++;
+    }
+    gnInputs = (range < 0x100000000ull) ? (uint32_t) range : 0;
+
+    if (gnInputs)
+    {
+        // A random pair collides when its difference is in the kernel, 1 in 2^rank
+        const double expected = (double) gnInputs * (double)(gnInputs - 1) / 2.0 / ldexp( 1.0, rank );
+        printf( "// %u inputs, about %.0f collisions among them\n", gnInputs, expected );
+        if (expected < (double) gnWanted)
+            printf( "WARNING: Fewer collisions than -k may exist, use a longer length or larger charset\n" );
+    }
+
+#if USE_OMP
+    Threads_Set();
+#endif // USE_OMP
+
+    printf( "Using: %u / %u threads\n", gnThreadsActive, gnThreadsMaximum );
+    printf( "Searching for CRC32%c() collisions...\n", cSearchCRC32 );
+
+    Timer timer;
+    timer.Start();
+        Search();
+    timer.Stop();
+    timer.Print();
+
+    return gnErrors ? 1 : 0;
+}
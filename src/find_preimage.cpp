@@ -0,0 +1,375 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Meet-in-the-middle search for inputs of length N, restricted to a
+character set C, that hash to a target CRC32.
+
+    Forward : Hash table of the CRC state after every prefix of P chars.
+    Backward: Start at ~target and run the CRC backwards (see crc32_inverse.h)
+              over every suffix of S = N-P chars, looking up each state.
+
+Every state match is an exact preimage, so the cost is |C|^P + |C|^S
+instead of the |C|^N of brute force.
+
+Since each backward leaf matches with probability |C|^P / 2^32, P is made
+as large as the table memory allows (up to N/2) to find inputs faster.
+
+*/
+
+// Defines
+    #define USE_OMP 1
+#if _WIN32
+    #define _CRT_SECURE_NO_WARNINGS 1
+#endif
+
+// Includes
+    #include "common.cpp"
+
+// BEGIN OMP
+#if USE_OMP
+    #include <omp.h>
+#endif
+    #include "util_threads.h"
+    #include "util_timer.h"
+// END OMP
+    #include "charset.h"
+    #include "crc32_inverse.h"
+
+// Consts
+    const int MAX_LENGTH = 64;
+    const int MAX_SLOT_BITS = 31; // Slot_Hash() shifts by 32 - bits, the mask is 1 << bits
+
+// Types
+    struct Slot
+    {
+        uint32_t state ;
+        uint32_t prefix; // rank + 1, 0 = empty
+    };
+
+// Vars
+    const uint32_t *gpTable      = CRC32_REVERSE;
+    uint8_t         gaInverse[ 256 ];
+    char            cSearchCRC32 = 'b';
+
+    Charset         gCharset;
+    int             gnLength     = 8;
+    int             gnPrefix     = 0; // P chars in forward table
+    int             gnSuffix     = 0; // S chars searched backwards
+    uint32_t        gnTarget     = 0;
+    uint64_t        gnWanted     = 10; // 0 = all
+    uint64_t        gnFound      = 0;
+    volatile bool   gbDone       = false;
+    size_t          gnMemoryMB   = 256;
+
+    Slot           *gaSlots      = NULL;
+    uint32_t        gnSlotBits   = 0;
+    uint32_t        gnSlotMask   = 0;
+
+// Hash Table
+
+    // ========================================================================
+    inline uint32_t Slot_Hash( const uint32_t state )
+    {
+        return (state * 0x9E3779B1u) >> (32 - gnSlotBits);
+    }
+
+    // ========================================================================
+    void Slot_Insert( const uint32_t state, const uint32_t rank )
+    {
+        uint32_t slot = Slot_Hash( state );
+        while( gaSlots[ slot ].prefix )
+            slot = (slot + 1) & gnSlotMask;
+
+        gaSlots[ slot ].state  = state;
+        gaSlots[ slot ].prefix = rank + 1;
+    }
+
+// Search
+
+    // Prefix rank is base |C| with the first char most significant
+    // ========================================================================
+    void Forward_Node( const uint32_t crc, const uint32_t rank, const int depth )
+    {
+        if (depth == gnPrefix)
+        {
+            Slot_Insert( crc, rank );
+            return;
+        }
+
+        for( int i = 0; i < gCharset.count; i++ )
+        {
+            const uint8_t c = gCharset.chars[ i ];
+            Forward_Node( gpTable[ (crc ^ c) & 0xFF ] ^ (crc >> 8), rank * gCharset.count + i, depth + 1 );
+        }
+    }
+
+    // ========================================================================
+    void Report( uint32_t rank, const uint8_t *suffix )
+    {
+        unsigned char data[ MAX_LENGTH + 1 ];
+        char          text[ MAX_LENGTH + 1 ];
+
+        for( int offset = gnPrefix - 1; offset >= 0; offset-- )
+        {
+            data[ offset ] = gCharset.chars[ rank % gCharset.count ];
+            rank /= gCharset.count;
+        }
+        memcpy( data + gnPrefix, suffix, gnSuffix );
+
+        for( int offset = 0; offset < gnLength; offset++ )
+            text[ offset ] = ((data[ offset ] < 0x20) || (data[ offset ] >= 0x7F)) ? '.' : (char) data[ offset ];
+        text[ gnLength ] = 0;
+
+        const uint32_t crc = crc32_100( gpTable, gnLength, data );
+
+#pragma omp critical (report)
+        {
+            if (!gnWanted || (gnFound < gnWanted))
+            {
+                printf( "CRC32%c( \"%s\" ) = %08X //", cSearchCRC32, text, crc );
+                for( int offset = 0; offset < gnLength; offset++ )
+                    printf( " %02X", data[ offset ] );
+                if (crc != gnTarget)
+                    printf( " ERROR: CRC32 not %08X!", gnTarget );
+                printf( "\n" );
+
+                gnFound++;
+                if (gnWanted && (gnFound >= gnWanted))
+                    gbDone = true;
+            }
+        }
+    }
+
+    // suffix[ gnSuffix - depth .. gnSuffix-1 ] are already chosen
+    // ========================================================================
+    void Backward_Node( const uint32_t crc, const int depth, uint8_t *suffix )
+    {
+        if (gbDone)
+            return;
+
+        if (depth == gnSuffix)
+        {
+            for( uint32_t slot = Slot_Hash( crc ); gaSlots[ slot ].prefix; slot = (slot + 1) & gnSlotMask )
+                if (gaSlots[ slot ].state == crc)
+                    Report( gaSlots[ slot ].prefix - 1, suffix );
+            return;
+        }
+
+        for( int i = 0; i < gCharset.count; i++ )
+        {
+            const uint8_t c = gCharset.chars[ i ];
+            suffix[ gnSuffix - 1 - depth ] = c;
+            Backward_Node( crc32_unstep( gpTable, gaInverse, crc, c ), depth + 1, suffix );
+        }
+    }
+
+    // ========================================================================
+    void Search()
+    {
+        uint64_t       nEntriesMax = ((uint64_t)gnMemoryMB << 20) / sizeof( Slot ) / 2; // 50% load
+        if (nEntriesMax > (1ull << (MAX_SLOT_BITS - 1)))
+            nEntriesMax = (1ull << (MAX_SLOT_BITS - 1)); // any larger -M is clamped
+              uint64_t nEntries    = 1;
+
+        gnPrefix = 0;
+        while( (gnPrefix < (gnLength + 1) / 2)
+           &&  (nEntries * gCharset.count <= nEntriesMax)
+           &&  (nEntries * gCharset.count <  0xFFFFFFFFull) )
+        {
+            nEntries *= gCharset.count;
+            gnPrefix++;
+        }
+        gnSuffix = gnLength - gnPrefix;
+
+        gnSlotBits = 1;
+        while( (1ull << gnSlotBits) < 2 * nEntries )
+            gnSlotBits++;
+        gnSlotMask = (1u << gnSlotBits) - 1;
+
+        gaSlots = (Slot*) calloc( (size_t)1 << gnSlotBits, sizeof( Slot ) );
+        if (!gaSlots)
+        {
+            printf( "ERROR: Couldn't allocate forward table, try a smaller -M\n" );
+            return;
+        }
+
+        printf( "// Length %d = prefix %d + suffix %d, charset %d chars\n", gnLength, gnPrefix, gnSuffix, gCharset.count );
+        printf( "// Forward : %llu states in %llu slots\n", (unsigned long long) nEntries, 1ull << gnSlotBits );
+
+        Forward_Node( 0xFFFFFFFF, 0, 0 );
+
+        // Work items are the last one or two chars, which are undone first
+        const int nTop   = (gnSuffix >= 2) ? 2 : gnSuffix;
+              int nItems = 1;
+        for( int i = 0; i < nTop; i++ )
+            nItems *= gCharset.count;
+
+        printf( "// Backward: %d work items\n", nItems );
+
+#pragma omp parallel for schedule(dynamic)
+        for( int iItem = 0; iItem < nItems; iItem++ )
+        {
+            uint8_t  suffix[ MAX_LENGTH ];
+            uint32_t crc  = ~gnTarget;
+            int      item = iItem;
+
+            for( int depth = 0; depth < nTop; depth++ )
+            {
+                const uint8_t c = gCharset.chars[ item % gCharset.count ];
+                item /= gCharset.count;
+
+                suffix[ gnSuffix - 1 - depth ] = c;
+                crc = crc32_unstep( gpTable, gaInverse, crc, c );
+            }
+
+            Backward_Node( crc, nTop, suffix );
+        }
+
+        free( gaSlots );
+        gaSlots = NULL;
+
+        printf( "// Found %llu of length %d\n", (unsigned long long) gnFound, gnLength );
+    }
+
+// ========================================================================
+int Usage()
+{
+    printf(
+"Find CRC32 preimages with a meet-in-the-middle search\n"
+"https://github.com/Michaelangel007/crc32\n"
+"\n"
+"Usage: preimage [options] target\n"
+"    -?   Display usage\n"
+"    -b   Use CRC32B (default)\n"
+"    -c   Use CRC32C\n"
+"    -j#  Use # threads\n"
+"    -k#  Stop after finding # inputs, 0 = all (default 10)\n"
+"    -l#  Input length (default 8)\n"
+"    -M#  Memory for forward table in MB (default 256)\n"
+"    -s<classes>  Character set, union of classes (default lud)\n"
+"         l = a-z, u = A-Z, d = 0-9, h = 0-9a-f, H = 0-9A-F\n"
+"         s = symbols, a = printable, b = all bytes\n"
+"\n"
+"Examples:\n"
+"\n"
+"Find 10 alphanumeric inputs of length 8 with the same CRC32B as '123456789'\n"
+"    ./preimage CBF43926\n"
+"Find all 9 digit inputs for it\n"
+"    ./preimage -sd -l9 -k0 CBF43926\n"
+"Find 12 printable chars that CRC32C to zero\n"
+"    ./preimage -c -sa -l12 0\n"
+    );
+
+    return 0;
+}
+
+// ========================================================================
+int main(int nArg, char *aArg[])
+{
+    common_init( false );
+
+    bool bTarget = false;
+    Charset_Parse( &gCharset, "lud" );
+
+#if USE_OMP
+    Threads_Default();
+#endif // USE_OMP
+
+    for( int iArg = 1; iArg < nArg; iArg++ )
+    {
+        char *pArg = aArg[ iArg ];
+        if (pArg[0] == '-')
+        {
+            pArg++; // point to 1st char in option
+
+            if (*pArg == '?') return Usage();
+            if (*pArg == 'b')
+            {
+                cSearchCRC32 = 'b';
+                gpTable      = CRC32_REVERSE;
+            }
+            else
+            if (*pArg == 'c')
+            {
+                cSearchCRC32 = 'c';
+                gpTable      = CRC32C_REVERSED;
+            }
+            else
+#if USE_OMP
+            if( *pArg == 'j' )
+            {
+                int i = atoi( pArg+1 );
+                if( i > 0 )
+                    gnThreadsActive = i;
+                if( gnThreadsActive > MAX_THREADS )
+                    gnThreadsActive = MAX_THREADS;
+            }
+            else
+#endif // USE_OMP
+            if (*pArg == 'k')
+                gnWanted = strtoull( pArg+1, NULL, 10 );
+            else
+            if (*pArg == 'l')
+            {
+                gnLength = atoi( pArg+1 );
+                if ((gnLength < 1) || (gnLength > MAX_LENGTH))
+                {
+                    printf( "ERROR: Length must be 1..%d\n", MAX_LENGTH );
+                    return 1;
+                }
+            }
+            else
+            if (*pArg == 'M')
+            {
+                int mb = atoi( pArg+1 );
+                if (mb > 0)
+                    gnMemoryMB = mb;
+            }
+            else
+            if (*pArg == 's')
+            {
+                if (!Charset_Parse( &gCharset, pArg+1 ))
+                {
+                    printf( "ERROR: Unknown character class in: %s\n", pArg+1 );
+                    return 1;
+                }
+            }
+            else
+                printf( "Unrecognized option: %c\n", *pArg );
+        }
+        else
+        {
+            gnTarget = strtoul( pArg, 0, 16 );
+            bTarget  = true;
+        }
+    }
+
+    if (!bTarget)
+        return Usage();
+
+    if (!crc32_init_inverse( gpTable, gaInverse ))
+    {
+        printf( "ERROR: CRC32%c table isn't invertible\n", cSearchCRC32 );
+        return 1;
+    }
+
+#if USE_OMP
+    Threads_Set();
+#endif // USE_OMP
+
+    printf( "Using: %u / %u threads\n", gnThreadsActive, gnThreadsMaximum );
+    printf( "Searching for CRC32%c() = %08X...\n", cSearchCRC32, gnTarget );
+
+    Timer timer;
+    timer.Start();
+        Search();
+    timer.Stop();
+    timer.Print();
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Binary results database for CRC32 preimages.
+
+File layout (little endian):
+
+    +--------------------+
+    | ResultsHeader      |  16 bytes: magic "CRCZ", version, count
+    +--------------------+
+    | ResultsRecord [0]  |  16 bytes each, sorted by (model, length, target, key)
+    | ...                |
+    | ResultsRecord [n-1]|
+    +--------------------+
+
+Since the records are fixed size and sorted the file can be mmap()'d
+and queried directly with a binary search in O(log n).
+
+*/
+
+#if _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+    #include <io.h> // _unlink()
+#else
+    #include <fcntl.h>    // open()
+    #include <sys/mman.h> // mmap()
+    #include <sys/stat.h> // fstat()
+    #include <unistd.h>   // close()
+#endif
+
+// Consts
+
+    const char     RESULTS_MAGIC[4] = { 'C', 'R', 'C', 'Z' };
+    const uint32_t RESULTS_VERSION  = 1;
+
+// Types
+
+    struct ResultsHeader
+    {
+        char     magic[4];
+        uint32_t version ;
+        uint64_t count   ; // number of records following the header
+    };
+
+    // Model is the CRC32 variant the key was found for, i.e. 'b' = CRC32B, 'c' = CRC32C
+    struct ResultsRecord
+    {
+        uint8_t  model   ;
+        uint8_t  length  ; // number of bytes of key used, 1..8
+        uint16_t reserved;
+        uint32_t target  ; // crc( key ) == target
+        uint64_t key     ; // NOTE: In Little Endian format!
+    };
+
+    int ERROR_ResultsHeader_not_16_bytes[ sizeof( ResultsHeader ) == 16 ];
+    int ERROR_ResultsRecord_not_16_bytes[ sizeof( ResultsRecord ) == 16 ];
+
+    // Read-only mapped view of a results file
+    struct ResultsDb
+    {
+        const ResultsHeader *header ;
+        const ResultsRecord *records;
+              uint64_t       count  ;
+              size_t         size   ; // bytes mapped
+#if _WIN32
+              HANDLE         hFile  ;
+              HANDLE         hMap   ;
+#else
+              int            fd     ;
+#endif
+    };
+
+// Utility
+
+    // ========================================================================
+    inline int ResultsRecord_Compare( const ResultsRecord *a, const ResultsRecord *b )
+    {
+        if (a->model  != b->model ) return (a->model  < b->model ) ? -1 : 1;
+        if (a->length != b->length) return (a->length < b->length) ? -1 : 1;
+        if (a->target != b->target) return (a->target < b->target) ? -1 : 1;
+        if (a->key    != b->key   ) return (a->key    < b->key   ) ? -1 : 1;
+        return 0;
+    }
+
+    // qsort() callback
+    // ========================================================================
+    int ResultsRecord_Sort( const void *a, const void *b )
+    {
+        return ResultsRecord_Compare( (const ResultsRecord*) a, (const ResultsRecord*) b );
+    }
+
+// Lookup
+
+    void ResultsDb_Close( ResultsDb *db );
+
+    // Returns false if the file is missing, truncated, or not a results file
+    // ========================================================================
+    bool ResultsDb_Open( ResultsDb *db, const char *filename )
+    {
+        memset( db, 0, sizeof( *db ) );
+
+#if _WIN32
+        db->hFile = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+        if (db->hFile == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        GetFileSizeEx( db->hFile, &size );
+        db->size = (size_t) size.QuadPart;
+
+        if (db->size >= sizeof( ResultsHeader ))
+        {
+            db->hMap = CreateFileMappingA( db->hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+            if (db->hMap)
+                db->header = (const ResultsHeader*) MapViewOfFile( db->hMap, FILE_MAP_READ, 0, 0, 0 );
+        }
+#else
+        db->fd = open( filename, O_RDONLY );
+        if (db->fd < 0)
+            return false;
+
+        struct stat info;
+        fstat( db->fd, &info );
+        db->size = (size_t) info.st_size;
+
+        if (db->size >= sizeof( ResultsHeader ))
+        {
+            void *view = mmap( NULL, db->size, PROT_READ, MAP_SHARED, db->fd, 0 );
+            if (view != MAP_FAILED)
+                db->header = (const ResultsHeader*) view;
+        }
+#endif
+
+        const ResultsHeader *header = db->header;
+        if (!header
+        ||  (memcmp( header->magic, RESULTS_MAGIC, sizeof( RESULTS_MAGIC ) ) != 0)
+        ||  (header->version != RESULTS_VERSION)
+        ||  (header->count > (db->size - sizeof( ResultsHeader )) / sizeof( ResultsRecord )))
+        {
+            printf( "ERROR: '%s' is not a valid results file\n", filename );
+            ResultsDb_Close( db );
+            return false;
+        }
+
+        db->records = (const ResultsRecord*) (header + 1);
+        db->count   = header->count;
+        return true;
+    }
+
+    // ========================================================================
+    void ResultsDb_Close( ResultsDb *db )
+    {
+#if _WIN32
+        if (db->header) UnmapViewOfFile( db->header );
+        if (db->hMap  ) CloseHandle( db->hMap );
+        if (db->hFile && (db->hFile != INVALID_HANDLE_VALUE)) CloseHandle( db->hFile );
+#else
+        if (db->header) munmap( (void*) db->header, db->size );
+        if (db->fd > 0) close( db->fd );
+#endif
+        memset( db, 0, sizeof( *db ) );
+    }
+
+    // Binary search for all keys where crc( key ) == target
+    // @return pointer to first matching record, nCount set to number of consecutive matches
+    // ========================================================================
+    const ResultsRecord* ResultsDb_Find( const ResultsDb *db, const uint8_t model, const uint8_t length, const uint32_t target, uint64_t *nCount )
+    {
+        ResultsRecord lower = { model, length, 0, target, 0 };
+
+        uint64_t lo = 0;
+        uint64_t hi = db->count;
+        while (lo < hi)
+        {
+            uint64_t mid = lo + (hi - lo) / 2;
+            if (ResultsRecord_Compare( &db->records[ mid ], &lower ) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        uint64_t end = lo;
+        while ((end < db->count)
+            && (db->records[ end ].model  == model )
+            && (db->records[ end ].length == length)
+            && (db->records[ end ].target == target))
+            end++;
+
+        if (nCount)
+           *nCount = end - lo;
+        return &db->records[ lo ];
+    }
+
+// Update
+
+    // Merge new records into the (possibly missing) results file, keeping it sorted and unique
+    // @return number of records in the file, or -1 on error
+    // ========================================================================
+    int64_t ResultsDb_Merge( const char *filename, const ResultsRecord *added, const size_t nAdded )
+    {
+        ResultsDb db;
+        bool      bExists = ResultsDb_Open( &db, filename );
+        if (!bExists)
+        {
+            // Never clobber a file we couldn't parse
+            FILE *probe = fopen( filename, "rb" );
+            if (probe)
+            {
+                fclose( probe );
+                return -1;
+            }
+        }
+        uint64_t  nOld    = bExists ? db.count : 0;
+        uint64_t  nTotal  = nOld + nAdded;
+
+        ResultsRecord *records = (ResultsRecord*) malloc( (size_t)(nTotal + 1) * sizeof( ResultsRecord ) );
+        if (!records)
+        {
+            ResultsDb_Close( &db );
+            return -1;
+        }
+
+        if (nOld  ) memcpy( records       , db.records, (size_t) nOld * sizeof( ResultsRecord ) );
+        if (nAdded) memcpy( records + nOld, added     , nAdded        * sizeof( ResultsRecord ) );
+        ResultsDb_Close( &db );
+
+        qsort( records, (size_t) nTotal, sizeof( ResultsRecord ), ResultsRecord_Sort );
+
+        uint64_t nUnique = 0;
+        for( uint64_t iRecord = 0; iRecord < nTotal; iRecord++ )
+            if (!nUnique || ResultsRecord_Compare( &records[ nUnique-1 ], &records[ iRecord ] ))
+                records[ nUnique++ ] = records[ iRecord ];
+
+        // Write to a temporary and rename so readers never see a partial file
+        char temp[ 4096 ];
+        snprintf( temp, sizeof( temp ), "%s.tmp", filename );
+
+        FILE *file = fopen( temp, "wb" );
+        if (!file)
+        {
+            free( records );
+            printf( "ERROR: Couldn't write results file '%s'\n", temp );
+            return -1;
+        }
+
+        ResultsHeader header;
+        memcpy( header.magic, RESULTS_MAGIC, sizeof( RESULTS_MAGIC ) );
+        header.version = RESULTS_VERSION;
+        header.count   = nUnique;
+
+        bool bOK = (fwrite( &header, sizeof( header ),       1, file ) == 1)
+                && (fwrite( records, sizeof( ResultsRecord ), (size_t) nUnique, file ) == nUnique);
+        bOK = (fclose( file ) == 0) && bOK;
+        free( records );
+
+#if _WIN32
+        if (bOK) bOK = MoveFileExA( temp, filename, MOVEFILE_REPLACE_EXISTING ) != 0;
+        if(!bOK) _unlink( temp );
+#else
+        if (bOK) bOK = rename( temp, filename ) == 0;
+        if(!bOK) unlink( temp );
+#endif
+        if (!bOK)
+        {
+            printf( "ERROR: Couldn't write results file '%s'\n", filename );
+            return -1;
+        }
+
+        return (int64_t) nUnique;
+    }
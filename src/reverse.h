@@ -6,13 +6,29 @@ https://github.com/Michaelangel007/crc32
 Michaelangel007
 Copyleft (C) 2017
 
+Bit reversal of words.
+
+reverse32() and reverse64() reverse the bits within each byte with three
+mask and shift steps, then reverse the bytes with bswap. Compilers
+without a bswap builtin fall back to REVERSE_BITS lookups.
+
 */
 
 // Global
     // Before using must first call:
-    //     reverse_init()
-    // NOTE: If you're thrashing the L1 cache, change to uint8_t
-    extern uint32_t REVERSE_BITS[ 256 ]; // 8-bit reverse bit look-up table
+    //     ReverseBits_Init()
+    // 256 bytes, 4 cache lines, so it doesn't thrash the L1 cache
+    extern uint8_t REVERSE_BITS[ 256 ]; // 8-bit reverse bit look-up table
+
+// Macros
+
+#if defined(__GNUC__)
+    #define REVERSE_BSWAP32(x) __builtin_bswap32( x )
+    #define REVERSE_BSWAP64(x) __builtin_bswap64( x )
+#elif defined(_MSC_VER)
+    #define REVERSE_BSWAP32(x) _byteswap_ulong( x )
+    #define REVERSE_BSWAP64(x) _byteswap_uint64( x )
+#endif
 
 // Utility
 
@@ -51,18 +67,51 @@ Copyleft (C) 2017
         return bits;
     }
 
-    /** Table-Lookup
+    // Reverse the bits of each byte, in place: swap nibbles, pairs, then bits
+    // ========================================================================
+    inline uint32_t reverse_bytes32( uint32_t x )
+    {
+        x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+        x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+        x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+        return x;
+    }
+
+    // ========================================================================
+    inline uint64_t reverse_bytes64( uint64_t x )
+    {
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+        x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+        x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+        return x;
+    }
+
+    /** Bits within bytes, then bswap, else Table-Lookup
      * @param  {uint32_t} x - value to bit-reverse
      * @return {uint32_t}     value bit reversed
      */
     // ========================================================================
     inline uint32_t reverse32( const uint32_t x )
     {
+#ifdef REVERSE_BSWAP32
+        return REVERSE_BSWAP32( reverse_bytes32( x ) );
+#else
         return 0
-        | REVERSE_BITS[ (x >> 24) & 0xFF ] <<  0L
-        | REVERSE_BITS[ (x >> 16) & 0xFF ] <<  8L
-        | REVERSE_BITS[ (x >>  8) & 0xFF ] << 16L
-        | REVERSE_BITS[ (x >>  0) & 0xFF ] << 24L;
+        | (uint32_t) REVERSE_BITS[ (x >> 24) & 0xFF ] <<  0L
+        | (uint32_t) REVERSE_BITS[ (x >> 16) & 0xFF ] <<  8L
+        | (uint32_t) REVERSE_BITS[ (x >>  8) & 0xFF ] << 16L
+        | (uint32_t) REVERSE_BITS[ (x >>  0) & 0xFF ] << 24L;
+#endif
+    }
+
+    // ========================================================================
+    inline uint64_t reverse64( const uint64_t x )
+    {
+#ifdef REVERSE_BSWAP64
+        return REVERSE_BSWAP64( reverse_bytes64( x ) );
+#else
+        return ((uint64_t) reverse32( (uint32_t) x ) << 32) | reverse32( (uint32_t)(x >> 32) );
+#endif
     }
 
     // Table-Lookup
@@ -70,7 +119,7 @@ Copyleft (C) 2017
     void ReverseBits_Init()
     {
         for( int byte = 0; byte < 256; byte++ )
-            REVERSE_BITS[ byte ] = (reflect32( byte ) >> 24) & 0xFF;
+            REVERSE_BITS[ byte ] = (uint8_t)((reflect32( byte ) >> 24) & 0xFF);
 
 //      for( int byte = 0; byte < 256; byte++ )
 //          printf( "Byte: %02X -> %08X -> %02X\n", byte, reflect32( byte ), (reflect32( byte ) >> 24) & 0xFF );
@@ -0,0 +1,181 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+High resolution timing for benchmarks.
+
+Timer uses gettimeofday(), which only has microsecond resolution and
+follows wall clock adjustments. This uses:
+
+    POSIX: clock_gettime( CLOCK_MONOTONIC_RAW ), nanoseconds, never adjusted
+    Win32: QueryPerformanceCounter()
+    x86  : rdtsc for cycle counts, at the nominal TSC frequency
+
+A measurement runs warmup trials, then repeated trials of a fixed number
+of calls, and reports the min, median, and p99 per call. The min is the
+best case, the median is robust to interrupts, p99 shows the jitter.
+
+Must include util_cpu.h first.
+
+*/
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+#else
+    #include <time.h>
+#endif
+
+// Consts
+
+    const int MAX_TRIALS = 1024;
+
+// Types
+
+    // Runs the measured code nCalls times
+    typedef void (*BenchBody_t)( void *context, uint64_t nCalls );
+
+    struct BenchStats
+    {
+        uint64_t calls ; // per trial
+        int      trials;
+
+        // Per call
+        double   min_ns   , median_ns   , p99_ns   ;
+        double   min_cycles, median_cycles, p99_cycles;
+    };
+
+// Clock
+
+    // ========================================================================
+    inline uint64_t Clock_Ns()
+    {
+#ifdef _WIN32
+        static LARGE_INTEGER frequency = { 0 };
+        LARGE_INTEGER        counter;
+        if (!frequency.QuadPart)
+            QueryPerformanceFrequency( &frequency );
+        QueryPerformanceCounter( &counter );
+        return (uint64_t)((double) counter.QuadPart * 1e9 / (double) frequency.QuadPart);
+#else
+        timespec now;
+    #ifdef CLOCK_MONOTONIC_RAW
+        clock_gettime( CLOCK_MONOTONIC_RAW, &now );
+    #else
+        clock_gettime( CLOCK_MONOTONIC, &now );
+    #endif
+        return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+#endif
+    }
+
+    // 0 if there is no cycle counter
+    // ========================================================================
+    inline uint64_t Clock_Cycles()
+    {
+#if CPU_X86
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+// Implementation
+
+    // ========================================================================
+    int Bench_CompareDouble( const void *a, const void *b )
+    {
+        const double x = *(const double*) a;
+        const double y = *(const double*) b;
+        return (x > y) - (x < y);
+    }
+
+    // Sorts aSample
+    // ========================================================================
+    void Bench_Percentiles( double *aSample, const int nSample, double *pMin, double *pMedian, double *pP99 )
+    {
+        qsort( aSample, nSample, sizeof( double ), Bench_CompareDouble );
+
+        int p99 = (int)(0.99 * nSample + 0.5) - 1;
+        if (p99 < 0)
+            p99 = 0;
+
+        *pMin    = aSample[ 0 ];
+        *pMedian = (nSample & 1)
+            ?  aSample[ nSample/2 ]
+            : (aSample[ nSample/2 - 1 ] + aSample[ nSample/2 ]) / 2.;
+        *pP99    = aSample[ p99 ];
+    }
+
+    // Find the calls per trial so a trial takes at least nTrialNs
+    // @param pElapsed - optional, time of the last calibration trial
+    // ========================================================================
+    uint64_t Bench_Calibrate( BenchBody_t body, void *context, const uint64_t nTrialNs, uint64_t *pElapsed = NULL )
+    {
+        uint64_t nCalls = 1;
+        for( ;; )
+        {
+            const uint64_t start = Clock_Ns();
+                body( context, nCalls );
+            const uint64_t elapsed = Clock_Ns() - start;
+
+            if ((elapsed >= nTrialNs) || (nCalls >= (1ull << 40)))
+            {
+                if (pElapsed)
+                    *pElapsed = elapsed;
+                return nCalls;
+            }
+
+            // Aim a bit past the target, at most 16x per step
+            uint64_t scale = elapsed ? (nTrialNs * 2) / elapsed : 16;
+            if (scale < 2 ) scale = 2;
+            if (scale > 16) scale = 16;
+            nCalls *= scale;
+        }
+    }
+
+    // @param before - optional, runs untimed before every trial, i.e. to flush caches
+    // ========================================================================
+    void Bench_Measure( BenchStats *stats, BenchBody_t body, void *context, const uint64_t nCalls, const int nWarmup, int nTrials, BenchBody_t before = NULL )
+    {
+        static double aNs    [ MAX_TRIALS ];
+        static double aCycles[ MAX_TRIALS ];
+
+        if (nTrials < 1         ) nTrials = 1;
+        if (nTrials > MAX_TRIALS) nTrials = MAX_TRIALS;
+
+        for( int iWarmup = 0; iWarmup < nWarmup; iWarmup++ )
+        {
+            if (before)
+                before( context, 1 );
+            body( context, nCalls );
+        }
+
+        for( int iTrial = 0; iTrial < nTrials; iTrial++ )
+        {
+            if (before)
+                before( context, 1 );
+
+            const uint64_t startNs     = Clock_Ns();
+            const uint64_t startCycles = Clock_Cycles();
+                body( context, nCalls );
+            const uint64_t endCycles   = Clock_Cycles();
+            const uint64_t endNs       = Clock_Ns();
+
+            aNs    [ iTrial ] = (double)(endNs     - startNs    ) / nCalls;
+            aCycles[ iTrial ] = (double)(endCycles - startCycles) / nCalls;
+        }
+
+        stats->calls  = nCalls;
+        stats->trials = nTrials;
+        Bench_Percentiles( aNs    , nTrials, &stats->min_ns    , &stats->median_ns    , &stats->p99_ns     );
+        Bench_Percentiles( aCycles, nTrials, &stats->min_cycles, &stats->median_cycles, &stats->p99_cycles );
+    }
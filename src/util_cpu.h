@@ -0,0 +1,122 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+CPU feature detection for optional SIMD / hardware code paths.
+
+Code for an instruction set is compiled with a per-function target
+attribute, so the default build still runs on any x86-64, and callers
+pick the path at runtime with Cpu_Has*().
+
+*/
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CPU_X86 1
+#else
+    #define CPU_X86 0
+#endif
+
+#if CPU_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h> // __cpuidex()
+    #endif
+#endif
+
+// Macros
+
+    // MSVC compiles any intrinsic without flags
+#if CPU_X86 && defined(__GNUC__)
+    #define TARGET_SSSE3   __attribute__((target("ssse3")))
+    #define TARGET_SSE42   __attribute__((target("sse4.2")))
+    #define TARGET_PCLMUL  __attribute__((target("sse4.2,pclmul")))
+    #define TARGET_AVX2    __attribute__((target("avx2")))
+#else
+    #define TARGET_SSSE3
+    #define TARGET_SSE42
+    #define TARGET_PCLMUL
+    #define TARGET_AVX2
+#endif
+
+// Implementation
+
+#if CPU_X86
+    // ========================================================================
+    inline void Cpu_Id( const int leaf, const int subleaf, uint32_t regs[4] )
+    {
+    #if defined(_MSC_VER)
+        __cpuidex( (int*) regs, leaf, subleaf );
+    #else
+        __asm__ __volatile__( "cpuid"
+            : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3])
+            : "a"(leaf), "c"(subleaf) );
+    #endif
+    }
+
+    // OS must also save the YMM registers
+    // ========================================================================
+    inline bool Cpu_OsAvx()
+    {
+        uint32_t regs[4];
+        Cpu_Id( 1, 0, regs );
+        if (!(regs[2] & (1u << 27))) // OSXSAVE
+            return false;
+    #if defined(_MSC_VER)
+        const uint64_t xcr0 = _xgetbv( 0 );
+    #else
+        uint32_t lo, hi;
+        __asm__ __volatile__( "xgetbv" : "=a"(lo), "=d"(hi) : "c"(0) );
+        const uint64_t xcr0 = ((uint64_t)hi << 32) | lo;
+    #endif
+        return (xcr0 & 6) == 6;
+    }
+
+    // ========================================================================
+    inline bool Cpu_HasSSSE3 () { uint32_t r[4]; Cpu_Id( 1, 0, r ); return (r[2] & (1u <<  9)) != 0; }
+    inline bool Cpu_HasSSE42 () { uint32_t r[4]; Cpu_Id( 1, 0, r ); return (r[2] & (1u << 20)) != 0; }
+    inline bool Cpu_HasPCLMUL() { uint32_t r[4]; Cpu_Id( 1, 0, r ); return (r[2] & (1u <<  1)) != 0; }
+    inline bool Cpu_HasAVX2  ()
+    {
+        uint32_t r[4];
+        Cpu_Id( 0, 0, r );
+        if (r[0] < 7) // max leaf
+            return false;
+        Cpu_Id( 7, 0, r );
+        return (r[1] & (1u << 5)) && Cpu_OsAvx();
+    }
+
+    // i.e. "Intel(R) Core(TM) i7-8700K CPU @ 3.70GHz", brand needs 49 chars
+    // ========================================================================
+    inline void Cpu_Brand( char *brand )
+    {
+        uint32_t r[4];
+        strcpy( brand, "unknown" );
+
+        Cpu_Id( 0x80000000, 0, r );
+        if (r[0] < 0x80000004)
+            return;
+
+        for( int leaf = 0; leaf < 3; leaf++ )
+        {
+            Cpu_Id( 0x80000002 + leaf, 0, r );
+            memcpy( brand + 16*leaf, r, 16 );
+        }
+        brand[ 48 ] = 0;
+
+        // Intel pads the front with spaces
+        const char *text = brand;
+        while( *text == ' ' )
+            text++;
+        memmove( brand, text, strlen( text ) + 1 );
+    }
+#else
+    inline bool Cpu_HasSSSE3 () { return false; }
+    inline bool Cpu_HasSSE42 () { return false; }
+    inline bool Cpu_HasPCLMUL() { return false; }
+    inline bool Cpu_HasAVX2  () { return false; }
+    inline void Cpu_Brand( char *brand ) { strcpy( brand, "unknown" ); }
+#endif
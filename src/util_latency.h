@@ -0,0 +1,291 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Opt-in per-call latency histograms of CRC entry points, bucketed by
+message size, to find the tail: cold tables, page faults, interrupts.
+
+Compile with -DUSE_LATENCY=1, otherwise LATENCY_SCOPE() is empty and the
+dumps do nothing, so it costs nothing.
+
+An entry point marks itself with:
+
+    LATENCY_SCOPE( "crc32b", len );
+
+which times the rest of the scope. Every public kernel, update and fixed
+length entry point in crc32.h is marked, see bench -H.
+
+Values are kept HDR style, log-linear: exact below 32 ns, then 32
+sub-buckets per power of two, about 3% error, and the exact max. Sizes
+are grouped by powers of 4: < 16 B, < 64 B, ...
+
+Each thread records into its own buckets, allocated on first use, with
+no locks or atomics on the recording path. Latency_Dump() can be called
+at any time from any thread, it sums the threads as they are.
+
+*/
+
+#ifndef USE_LATENCY
+    #define USE_LATENCY 0
+#endif
+
+#if USE_LATENCY
+    #ifdef _WIN32
+        #ifndef WIN32_LEAN_AND_MEAN
+            #define WIN32_LEAN_AND_MEAN
+        #endif
+        #ifndef NOMINMAX
+            #define NOMINMAX
+        #endif
+        #include <Windows.h>
+    #else
+        #include <time.h>
+    #endif
+    #include <atomic>
+
+// Consts
+
+    const int LATENCY_ENTRIES = 32;
+    const int LATENCY_SIZES   = 12; // < 16 B .. >= 16 MB
+    const int LATENCY_SUB     = 5;  // bits, 32 sub-buckets
+    const int LATENCY_BUCKETS = (1 << LATENCY_SUB) * (40 - LATENCY_SUB + 2); // .. 2^41 ns = 36 minutes
+    const int LATENCY_MAX     = LATENCY_BUCKETS; // slot of the exact max
+
+// Types
+
+    struct LatencyThread
+    {
+        uint64_t      *aHist[ LATENCY_ENTRIES ]; // [ LATENCY_SIZES ][ LATENCY_BUCKETS + 1 ]
+        LatencyThread *next;
+    };
+
+// Vars
+
+    const char                  *gaLatencyName[ LATENCY_ENTRIES ];
+    std::atomic<int>             gnLatencyEntries( 0 );
+    std::atomic<LatencyThread*>  gpLatencyThreads( (LatencyThread*) NULL );
+    thread_local LatencyThread  *tpLatency = NULL;
+
+// Implementation
+
+    // ========================================================================
+    inline uint64_t Latency_Now()
+    {
+    #ifdef _WIN32
+        static LARGE_INTEGER frequency = { 0 };
+        LARGE_INTEGER        counter;
+        if (!frequency.QuadPart)
+            QueryPerformanceFrequency( &frequency );
+        QueryPerformanceCounter( &counter );
+        return (uint64_t)((double) counter.QuadPart * 1e9 / (double) frequency.QuadPart);
+    #else
+        timespec now;
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+    #endif
+    }
+
+    // ========================================================================
+    inline int Latency_Log2( uint64_t x )
+    {
+        int bit = 0;
+        while( x >>= 1 )
+            bit++;
+        return bit;
+    }
+
+    // ========================================================================
+    inline int Latency_Bucket( const uint64_t ns )
+    {
+        if (ns < (1u << LATENCY_SUB))
+            return (int) ns;
+
+        int exponent = Latency_Log2( ns );
+        if (exponent > 40)
+            return LATENCY_BUCKETS - 1;
+
+        const int sub = (int)(ns >> (exponent - LATENCY_SUB)) & ((1 << LATENCY_SUB) - 1);
+        return ((exponent - LATENCY_SUB + 1) << LATENCY_SUB) + sub;
+    }
+
+    // Smallest ns that lands in bucket
+    // ========================================================================
+    inline uint64_t Latency_BucketLow( const int bucket )
+    {
+        if (bucket < (1 << LATENCY_SUB))
+            return (uint64_t) bucket;
+
+        const int exponent = (bucket >> LATENCY_SUB) + LATENCY_SUB - 1;
+        const int sub      = bucket & ((1 << LATENCY_SUB) - 1);
+        return ((uint64_t)((1 << LATENCY_SUB) + sub)) << (exponent - LATENCY_SUB);
+    }
+
+    // ========================================================================
+    inline int Latency_SizeClass( const size_t size )
+    {
+        int size_class = 0;
+        for( size_t limit = 16; (size >= limit) && (size_class < LATENCY_SIZES - 1); limit <<= 2 )
+            size_class++;
+        return size_class;
+    }
+
+    // Thread safe, the same name returns the same id
+    // @return entry id, -1 if there are too many
+    // ========================================================================
+    int Latency_Register( const char *name )
+    {
+        static std::atomic<int> lock( 0 );
+        while( lock.exchange( 1 ) )
+            ;
+
+        int id = -1;
+        for( int iEntry = 0; iEntry < gnLatencyEntries; iEntry++ )
+            if (!strcmp( gaLatencyName[ iEntry ], name ))
+                id = iEntry;
+
+        if ((id < 0) && (gnLatencyEntries < LATENCY_ENTRIES))
+        {
+            id = gnLatencyEntries;
+            gaLatencyName[ id ] = name;
+            gnLatencyEntries++;
+        }
+
+        lock = 0;
+        return id;
+    }
+
+    // ========================================================================
+    void Latency_Record( const int id, const size_t size, const uint64_t ns )
+    {
+        if (id < 0)
+            return;
+
+        LatencyThread *thread = tpLatency;
+        if (!thread)
+        {
+            thread = (LatencyThread*) calloc( 1, sizeof( LatencyThread ) );
+            thread->next = gpLatencyThreads.load();
+            while( !gpLatencyThreads.compare_exchange_weak( thread->next, thread ) )
+                ;
+            tpLatency = thread;
+        }
+
+        uint64_t *hist = thread->aHist[ id ];
+        if (!hist)
+            hist = thread->aHist[ id ] = (uint64_t*) calloc( LATENCY_SIZES * (LATENCY_BUCKETS + 1), sizeof( uint64_t ) );
+
+        hist += Latency_SizeClass( size ) * (LATENCY_BUCKETS + 1);
+        hist[ Latency_Bucket( ns ) ]++;
+        if (ns > hist[ LATENCY_MAX ])
+            hist[ LATENCY_MAX ] = ns;
+    }
+
+    struct LatencyScope
+    {
+        int      id   ;
+        size_t   size ;
+        uint64_t start;
+
+        LatencyScope( const int id_, const size_t size_ ) : id( id_ ), size( size_ ), start( Latency_Now() ) {}
+       ~LatencyScope() { Latency_Record( id, size, Latency_Now() - start ); }
+    };
+
+    #define LATENCY_CONCAT2(a,b) a##b
+    #define LATENCY_CONCAT(a,b)  LATENCY_CONCAT2(a,b)
+    #define LATENCY_SCOPE(name,size) \
+        static const int LATENCY_CONCAT(latencyId,__LINE__) = Latency_Register( name ); \
+        LatencyScope LATENCY_CONCAT(latencyScope,__LINE__)( LATENCY_CONCAT(latencyId,__LINE__), size )
+
+    // @return ns at percentile p (0..1) of the bucket counts
+    // ========================================================================
+    uint64_t Latency_Percentile( const uint64_t *hist, const uint64_t nCalls, const double p )
+    {
+        const uint64_t rank = (uint64_t)(p * (double)(nCalls - 1));
+        uint64_t       seen = 0;
+
+        for( int bucket = 0; bucket < LATENCY_BUCKETS; bucket++ )
+        {
+            seen += hist[ bucket ];
+            if (seen > rank)
+            {
+                // Report the top of the bucket, but not past the max
+                const uint64_t high = Latency_BucketLow( bucket + 1 ) - 1;
+                return (high < hist[ LATENCY_MAX ]) ? high : hist[ LATENCY_MAX ];
+            }
+        }
+        return hist[ LATENCY_MAX ];
+    }
+
+    // Sums every thread, safe while they keep recording
+    // ========================================================================
+    void Latency_Dump( FILE *pFile = stdout )
+    {
+        static uint64_t aSum[ LATENCY_SIZES ][ LATENCY_BUCKETS + 1 ];
+        static const char *aSize[ LATENCY_SIZES ] =
+        {
+            "< 16 B", "< 64 B", "< 256 B", "< 1 KB", "< 4 KB", "< 16 KB", "< 64 KB", "< 256 KB", "< 1 MB", "< 4 MB", "< 16 MB", ">= 16 MB"
+        };
+
+        const int nEntries = gnLatencyEntries;
+        for( int iEntry = 0; iEntry < nEntries; iEntry++ )
+        {
+            memset( aSum, 0, sizeof( aSum ) );
+            for( const LatencyThread *thread = gpLatencyThreads.load(); thread; thread = thread->next )
+            {
+                const uint64_t *hist = thread->aHist[ iEntry ];
+                if (!hist)
+                    continue;
+
+                for( int iSize = 0; iSize < LATENCY_SIZES; iSize++, hist += LATENCY_BUCKETS + 1 )
+                {
+                    for( int bucket = 0; bucket < LATENCY_BUCKETS; bucket++ )
+                        aSum[ iSize ][ bucket ] += hist[ bucket ];
+                    if (hist[ LATENCY_MAX ] > aSum[ iSize ][ LATENCY_MAX ])
+                        aSum[ iSize ][ LATENCY_MAX ] = hist[ LATENCY_MAX ];
+                }
+            }
+
+            fprintf( pFile, "Latency: %s\n", gaLatencyName[ iEntry ] );
+            fprintf( pFile, "    %-9s  %12s  %10s  %10s  %10s  %10s  %10s ns\n", "Size", "Calls", "p50", "p99", "p99.9", "p99.99", "max" );
+
+            for( int iSize = 0; iSize < LATENCY_SIZES; iSize++ )
+            {
+                uint64_t nCalls = 0;
+                for( int bucket = 0; bucket < LATENCY_BUCKETS; bucket++ )
+                    nCalls += aSum[ iSize ][ bucket ];
+                if (!nCalls)
+                    continue;
+
+                fprintf( pFile, "    %-9s  %12llu  %10llu  %10llu  %10llu  %10llu  %10llu\n"
+                    , aSize[ iSize ]
+                    , (unsigned long long) nCalls
+                    , (unsigned long long) Latency_Percentile( aSum[ iSize ], nCalls, 0.5    )
+                    , (unsigned long long) Latency_Percentile( aSum[ iSize ], nCalls, 0.99   )
+                    , (unsigned long long) Latency_Percentile( aSum[ iSize ], nCalls, 0.999  )
+                    , (unsigned long long) Latency_Percentile( aSum[ iSize ], nCalls, 0.9999 )
+                    , (unsigned long long) aSum[ iSize ][ LATENCY_MAX ]
+                );
+            }
+        }
+    }
+
+    // Zeroes every thread's buckets, calls recorded meanwhile may survive
+    // ========================================================================
+    void Latency_Reset()
+    {
+        for( LatencyThread *thread = gpLatencyThreads.load(); thread; thread = thread->next )
+            for( int iEntry = 0; iEntry < LATENCY_ENTRIES; iEntry++ )
+                if (thread->aHist[ iEntry ])
+                    memset( thread->aHist[ iEntry ], 0, LATENCY_SIZES * (LATENCY_BUCKETS + 1) * sizeof( uint64_t ) );
+    }
+
+#else
+    #define LATENCY_SCOPE(name,size)
+
+    inline void Latency_Dump( FILE * = stdout ) {}
+    inline void Latency_Reset() {}
+#endif // USE_LATENCY
@@ -0,0 +1,220 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Hardware performance counters through Linux perf_event_open():
+
+    cycles, instructions, L1D read misses, branch misses, and task clock
+
+For table-driven CRCs the L1 misses and the load ports decide the speed,
+so IPC and misses per byte tell whether a table, i.e. REVERSE_BITS as
+uint32_t, is thrashing L1.
+
+Counters only count the thread that opened them. Multi-threaded callers
+open one set per thread from inside a parallel region, and sum them.
+
+Each counter is optional: VMs and containers often have no PMU, or
+perf_event_paranoid forbids it, and then it reads as unavailable.
+Counters that were multiplexed are scaled by time enabled / running.
+
+Other platforms compile to stubs that report nothing.
+
+*/
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <errno.h>
+    #define USE_PERF 1
+#else
+    #define USE_PERF 0
+#endif
+
+// Consts
+
+    enum PerfCounter_e
+    {
+         PERF_CYCLES
+        ,PERF_INSTRUCTIONS
+        ,PERF_L1D_MISSES
+        ,PERF_BRANCH_MISSES
+        ,PERF_TASK_CLOCK  // ns, software so usually available
+        ,NUM_PERF
+    };
+
+    const char *aPerfName[ NUM_PERF ] =
+    {
+         "cycles"
+        ,"instructions"
+        ,"L1D misses"
+        ,"branch misses"
+        ,"task clock"
+    };
+
+// Types
+
+    struct PerfCounters
+    {
+        int      fd   [ NUM_PERF ]; // -1 = unavailable
+        uint64_t value[ NUM_PERF ]; // after Perf_Read()
+        int      error;             // errno of the first counter that failed
+    };
+
+// Implementation
+
+    // @return true if any hardware counter opened
+    // ========================================================================
+    bool Perf_Open( PerfCounters *perf )
+    {
+        memset( perf->value, 0, sizeof( perf->value ) );
+        perf->error = 0;
+
+        for( int iCounter = 0; iCounter < NUM_PERF; iCounter++ )
+            perf->fd[ iCounter ] = -1;
+
+#if USE_PERF
+        const uint32_t aType[ NUM_PERF ] =
+        {
+             PERF_TYPE_HARDWARE
+            ,PERF_TYPE_HARDWARE
+            ,PERF_TYPE_HW_CACHE
+            ,PERF_TYPE_HARDWARE
+            ,PERF_TYPE_SOFTWARE
+        };
+        const uint64_t aConfig[ NUM_PERF ] =
+        {
+             PERF_COUNT_HW_CPU_CYCLES
+            ,PERF_COUNT_HW_INSTRUCTIONS
+            ,PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+            ,PERF_COUNT_HW_BRANCH_MISSES
+            ,PERF_COUNT_SW_TASK_CLOCK
+        };
+
+        bool bHardware = false;
+        for( int iCounter = 0; iCounter < NUM_PERF; iCounter++ )
+        {
+            perf_event_attr attr;
+            memset( &attr, 0, sizeof( attr ) );
+            attr.size           = sizeof( attr );
+            attr.type           = aType  [ iCounter ];
+            attr.config         = aConfig[ iCounter ];
+            attr.disabled       = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            perf->fd[ iCounter ] = (int) syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 ); // this thread, any cpu
+            if (perf->fd[ iCounter ] < 0)
+            {
+                if (!perf->error)
+                    perf->error = errno;
+            }
+            else
+            if (iCounter != PERF_TASK_CLOCK)
+                bHardware = true;
+        }
+        return bHardware;
+#else
+        return false;
+#endif
+    }
+
+    // ========================================================================
+    void Perf_Close( PerfCounters *perf )
+    {
+#if USE_PERF
+        for( int iCounter = 0; iCounter < NUM_PERF; iCounter++ )
+            if (perf->fd[ iCounter ] >= 0)
+            {
+                close( perf->fd[ iCounter ] );
+                perf->fd[ iCounter ] = -1;
+            }
+#endif
+    }
+
+    // @param request - PERF_EVENT_IOC_RESET, _ENABLE, or _DISABLE
+    // ========================================================================
+    void Perf_Ioctl( PerfCounters *perf, const unsigned long request )
+    {
+#if USE_PERF
+        for( int iCounter = 0; iCounter < NUM_PERF; iCounter++ )
+            if (perf->fd[ iCounter ] >= 0)
+                ioctl( perf->fd[ iCounter ], request, 0 );
+#else
+        (void) perf; (void) request;
+#endif
+    }
+
+#if USE_PERF
+    inline void Perf_Reset  ( PerfCounters *perf ) { Perf_Ioctl( perf, PERF_EVENT_IOC_RESET   ); }
+    inline void Perf_Enable ( PerfCounters *perf ) { Perf_Ioctl( perf, PERF_EVENT_IOC_ENABLE  ); }
+    inline void Perf_Disable( PerfCounters *perf ) { Perf_Ioctl( perf, PERF_EVENT_IOC_DISABLE ); }
+#else
+    inline void Perf_Reset  ( PerfCounters * ) {}
+    inline void Perf_Enable ( PerfCounters * ) {}
+    inline void Perf_Disable( PerfCounters * ) {}
+#endif
+
+    // ========================================================================
+    void Perf_Read( PerfCounters *perf )
+    {
+        for( int iCounter = 0; iCounter < NUM_PERF; iCounter++ )
+        {
+            perf->value[ iCounter ] = 0;
+#if USE_PERF
+            uint64_t data[3]; // value, time enabled, time running
+            if ((perf->fd[ iCounter ] >= 0) && (read( perf->fd[ iCounter ], data, sizeof( data ) ) == sizeof( data )))
+                perf->value[ iCounter ] = (data[2] && (data[2] < data[1]))
+                    ? (uint64_t)((double) data[0] * data[1] / data[2])
+                    : data[0];
+#endif
+        }
+    }
+
+    // Totals into sum, which takes the availability of perf
+    // ========================================================================
+    void Perf_Sum( PerfCounters *sum, const PerfCounters *aPerf, const int nPerf )
+    {
+        *sum = aPerf[ 0 ];
+        for( int iPerf = 1; iPerf < nPerf; iPerf++ )
+            for( int iCounter = 0; iCounter < NUM_PERF; iCounter++ )
+                sum->value[ iCounter ] += aPerf[ iPerf ].value[ iCounter ];
+    }
+
+    // @param nBytes - bytes processed, 0 = only totals and IPC
+    // ========================================================================
+    void Perf_Print( const PerfCounters *perf, const uint64_t nBytes, const char *indent = "" )
+    {
+        const bool bCycles = perf->fd[ PERF_CYCLES       ] >= 0;
+        const bool bInstr  = perf->fd[ PERF_INSTRUCTIONS ] >= 0;
+
+        printf( "%s", indent );
+        if (bCycles && bInstr && perf->value[ PERF_CYCLES ])
+            printf( "IPC %.2f  ", (double) perf->value[ PERF_INSTRUCTIONS ] / perf->value[ PERF_CYCLES ] );
+
+        bool bAny = false;
+        for( int iCounter = 0; iCounter < NUM_PERF; iCounter++ )
+        {
+            if (perf->fd[ iCounter ] < 0)
+                continue;
+            bAny = true;
+
+            if (iCounter == PERF_TASK_CLOCK)
+                printf( "%s %.3f ms  ", aPerfName[ iCounter ], perf->value[ iCounter ] / 1e6 );
+            else
+            if (nBytes)
+                printf( "%s/byte %.4f  ", aPerfName[ iCounter ], (double) perf->value[ iCounter ] / nBytes );
+            else
+                printf( "%s %llu  ", aPerfName[ iCounter ], (unsigned long long) perf->value[ iCounter ] );
+        }
+
+        if (!bAny)
+            printf( "perf counters unavailable" );
+        printf( "\n" );
+    }
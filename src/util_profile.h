@@ -0,0 +1,238 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Scoped hierarchical profiling timers.
+
+    PROFILE_SCOPE( "table init" );
+
+times the rest of the scope as a child of the enclosing scope. Each
+thread adds into its own counters, and the report at exit merges them
+into one tree:
+
+    Profile                           wall ms   thread ms      calls  threads
+    find_zero                        1234.567    1234.567          1        1
+      table init                        0.120       0.120          1        1
+      search                         1230.000    1230.000          1        1
+        crc evaluation               1229.000    9830.000        256        8
+      merge                             4.400       4.400          1        1
+
+wall ms is the busiest thread, thread ms the sum of all threads.
+
+Scopes in an OpenMP parallel region hang under the scope the region was
+started from. Keep scopes coarse, per page or block, not per candidate:
+a scope costs two clock reads.
+
+Off unless the environment has CRC32_PROFILE=1, then a disabled scope
+is a branch. The report goes to stderr.
+
+Must include util_bench.h first.
+
+*/
+
+#include <atomic>
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+// Consts
+
+    const int   MAX_PROFILE_NODES = 256;
+    const int   MAX_PROFILE_DEPTH = 32;
+    const char *PROFILE_ENV       = "CRC32_PROFILE";
+
+// Types
+
+    struct ProfileNode
+    {
+        const char *name  ;
+        int         parent; // -1 = root
+    };
+
+    struct ProfileThread
+    {
+        uint64_t       aNs   [ MAX_PROFILE_NODES ];
+        uint64_t       aCalls[ MAX_PROFILE_NODES ];
+        int            aStack[ MAX_PROFILE_DEPTH ];
+        int            depth;
+        ProfileThread *next ;
+    };
+
+// Vars
+
+    bool                        gbProfile = false;
+    ProfileNode                 gaProfileNode[ MAX_PROFILE_NODES ];
+    std::atomic<int>            gnProfileNodes  ( 0 );
+    std::atomic<int>            gnProfileFork   ( -1 ); // innermost scope outside of parallel regions
+    std::atomic<ProfileThread*> gpProfileThreads( (ProfileThread*) NULL );
+    thread_local ProfileThread *tpProfile = NULL;
+
+// Implementation
+
+    // ========================================================================
+    inline bool Profile_InParallel()
+    {
+#ifdef _OPENMP
+        return omp_in_parallel() != 0;
+#else
+        return false;
+#endif
+    }
+
+    // ========================================================================
+    ProfileThread* Profile_Thread()
+    {
+        ProfileThread *thread = tpProfile;
+        if (!thread)
+        {
+            thread = (ProfileThread*) calloc( 1, sizeof( ProfileThread ) );
+            thread->next = gpProfileThreads.load();
+            while( !gpProfileThreads.compare_exchange_weak( thread->next, thread ) )
+                ;
+            tpProfile = thread;
+        }
+        return thread;
+    }
+
+    // Nodes are only appended, so lookups don't lock
+    // @return node of name under parent, -1 if out of nodes
+    // ========================================================================
+    int Profile_Node( const int parent, const char *name )
+    {
+        int nNodes = gnProfileNodes.load();
+        for( int iNode = 0; iNode < nNodes; iNode++ )
+            if ((gaProfileNode[ iNode ].parent == parent) && !strcmp( gaProfileNode[ iNode ].name, name ))
+                return iNode;
+
+        static std::atomic<int> lock( 0 );
+        while( lock.exchange( 1 ) )
+            ;
+
+        // Another thread may have added it
+        int node = -1;
+        nNodes = gnProfileNodes.load();
+        for( int iNode = 0; (node < 0) && (iNode < nNodes); iNode++ )
+            if ((gaProfileNode[ iNode ].parent == parent) && !strcmp( gaProfileNode[ iNode ].name, name ))
+                node = iNode;
+
+        if ((node < 0) && (nNodes < MAX_PROFILE_NODES))
+        {
+            gaProfileNode[ nNodes ].name   = name;
+            gaProfileNode[ nNodes ].parent = parent;
+            node = nNodes;
+            gnProfileNodes.store( nNodes + 1 );
+        }
+
+        lock = 0;
+        return node;
+    }
+
+    struct ProfileScope
+    {
+        ProfileThread *thread;
+        int            node  ;
+        uint64_t       start ;
+
+        ProfileScope( const char *name ) : thread( NULL ), node( -1 ), start( 0 )
+        {
+            if (!gbProfile)
+                return;
+
+            thread = Profile_Thread();
+            if (thread->depth >= MAX_PROFILE_DEPTH)
+                return;
+
+            const int parent = thread->depth ? thread->aStack[ thread->depth - 1 ] : gnProfileFork.load();
+            node = Profile_Node( parent, name );
+            if (node < 0)
+                return;
+
+            thread->aStack[ thread->depth++ ] = node;
+            if (!Profile_InParallel())
+                gnProfileFork = node;
+            start = Clock_Ns();
+        }
+
+       ~ProfileScope()
+        {
+            if (node < 0)
+                return;
+
+            thread->aNs   [ node ] += Clock_Ns() - start;
+            thread->aCalls[ node ]++;
+            thread->depth--;
+            if (!Profile_InParallel())
+                gnProfileFork = thread->depth ? thread->aStack[ thread->depth - 1 ] : -1;
+        }
+    };
+
+    #define PROFILE_CONCAT2(a,b) a##b
+    #define PROFILE_CONCAT(a,b)  PROFILE_CONCAT2(a,b)
+    #define PROFILE_SCOPE(name)  ProfileScope PROFILE_CONCAT(profileScope,__LINE__)( name )
+
+    // ========================================================================
+    void Profile_PrintNode( FILE *pFile, const int parent, const int depth )
+    {
+        const int nNodes = gnProfileNodes.load();
+        for( int iNode = 0; iNode < nNodes; iNode++ )
+        {
+            if (gaProfileNode[ iNode ].parent != parent)
+                continue;
+
+            uint64_t nsTotal = 0, nsMax = 0, nCalls = 0;
+            int      nThreads = 0;
+            for( const ProfileThread *thread = gpProfileThreads.load(); thread; thread = thread->next )
+            {
+                if (!thread->aCalls[ iNode ])
+                    continue;
+
+                nsTotal += thread->aNs   [ iNode ];
+                nCalls  += thread->aCalls[ iNode ];
+                nThreads++;
+                if (thread->aNs[ iNode ] > nsMax)
+                    nsMax = thread->aNs[ iNode ];
+            }
+
+            char name[ 64 ];
+            snprintf( name, sizeof( name ), "%*s%s", 2*depth, "", gaProfileNode[ iNode ].name );
+            fprintf( pFile, "%-32s  %10.3f  %10.3f  %9llu  %7d\n"
+                , name
+                , nsMax   / 1e6
+                , nsTotal / 1e6
+                , (unsigned long long) nCalls
+                , nThreads
+            );
+
+            Profile_PrintNode( pFile, iNode, depth + 1 );
+        }
+    }
+
+    // ========================================================================
+    void Profile_Print( FILE *pFile = stderr )
+    {
+        if (!gbProfile || !gnProfileNodes.load())
+            return;
+
+        fprintf( pFile, "\n%-32s  %10s  %10s  %9s  %7s\n", "Profile", "wall ms", "thread ms", "calls", "threads" );
+        Profile_PrintNode( pFile, -1, 0 );
+    }
+
+    // ========================================================================
+    void Profile_AtExit()
+    {
+        Profile_Print( stderr );
+    }
+
+    // Turns profiling on if CRC32_PROFILE is set, and reports at exit
+    // ========================================================================
+    void Profile_Init()
+    {
+        const char *env = getenv( PROFILE_ENV );
+        gbProfile = env && *env && strcmp( env, "0" );
+        if (gbProfile)
+            atexit( Profile_AtExit );
+    }
@@ -1,7 +1,22 @@
+#if _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h> // SetThreadAffinityMask()
+#else
+    #include <sched.h>   // sched_setaffinity()
+    #include <stdlib.h>  // posix_memalign()
+#endif
+
     int       gnThreadsMaximum = 0 ;
     int       gnThreadsActive  = 0 ; // 0 = auto detect; > 0 use manual # of threads
 
     const int MAX_THREADS      = 256; // Threadripper 3990X
+    const int MAX_NODES        = 64 ; // NUMA nodes, i.e. 2 sockets, or 8 CCDs with NPS4/L3-as-NUMA
+
+    bool      gbThreadsNuma    = false; // true = pin threads to cores and replicate tables per node
+    int       gnNumaNodes      = 1 ;
+    int       gaThreadCore[ MAX_THREADS ]; // core each thread is pinned to
+    int       gaThreadNode[ MAX_THREADS ]; // NUMA node of each thread
 
 // ========================================================================
 void Threads_Default()
@@ -19,3 +34,163 @@ void Threads_Set()
 
     omp_set_num_threads( gnThreadsActive );
 }
+
+// NUMA
+
+    // Parse Linux cpulist or nodelist such as "0-7,16-23", returns number of entries
+    // ========================================================================
+    int Threads_ParseCpuList( const char *text, int *aCpu, const int nMax )
+    {
+        int nCpu = 0;
+        while( *text && (*text != '\n') )
+        {
+            char *end;
+            int first = (int) strtol( text, &end, 10 );
+            int last  = first;
+            if (end == text)
+                break;
+            if (*end == '-')
+                last = (int) strtol( end + 1, &end, 10 );
+            for( int cpu = first; (cpu <= last) && (nCpu < nMax); cpu++ )
+                aCpu[ nCpu++ ] = cpu;
+            text = (*end == ',') ? end + 1 : end;
+        }
+        return nCpu;
+    }
+
+    // Assigns each active thread a core, grouped by node so that
+    // threads [0, n0) run on node 0, [n0, n0+n1) on node 1, etc.
+    // With schedule(static) each node then gets a contiguous range of pages.
+    // ========================================================================
+    void Threads_Topology()
+    {
+        int aNodeCpu  [ MAX_NODES ][ MAX_THREADS ];
+        int aNodeCount[ MAX_NODES ];
+        int nCpuTotal = 0;
+
+        gnNumaNodes = 0;
+#if !_WIN32
+        // Node ids can have gaps, i.e. "0,2-3" after offlining a node
+        int  aNodeId[ MAX_NODES ];
+        int  nNodeIds = 0;
+        char text[ 1024 ];
+
+        FILE *online = fopen( "/sys/devices/system/node/online", "r" );
+        if (online)
+        {
+            if (fgets( text, sizeof( text ), online ))
+                nNodeIds = Threads_ParseCpuList( text, aNodeId, MAX_NODES );
+            fclose( online );
+        }
+        if (!nNodeIds) // No list, probe every possible node
+            for( nNodeIds = 0; nNodeIds < MAX_NODES; nNodeIds++ )
+                aNodeId[ nNodeIds ] = nNodeIds;
+
+        for( int iNodeId = 0; iNodeId < nNodeIds; iNodeId++ )
+        {
+            char path[ 64 ];
+            snprintf( path, sizeof( path ), "/sys/devices/system/node/node%d/cpulist", aNodeId[ iNodeId ] );
+
+            FILE *file = fopen( path, "r" );
+            if (!file)
+                continue;
+            if (!fgets( text, sizeof( text ), file ))
+                text[0] = 0;
+            fclose( file );
+
+            aNodeCount[ gnNumaNodes ] = Threads_ParseCpuList( text, aNodeCpu[ gnNumaNodes ], MAX_THREADS );
+            if (aNodeCount[ gnNumaNodes ])
+            {
+                nCpuTotal += aNodeCount[ gnNumaNodes ];
+                gnNumaNodes++;
+            }
+        }
+#endif
+        if (!gnNumaNodes) // No NUMA info: single node with all processors
+        {
+            gnNumaNodes   = 1;
+            aNodeCount[0] = gnThreadsMaximum;
+            for( int cpu = 0; cpu < gnThreadsMaximum; cpu++ )
+                aNodeCpu[0][ cpu ] = cpu;
+            nCpuTotal = gnThreadsMaximum;
+        }
+
+        // Spread threads across nodes proportional to each node's cores
+        int iThread = 0;
+        for( int iNode = 0; iNode < gnNumaNodes; iNode++ )
+        {
+            int nThreads = (iNode == gnNumaNodes - 1)
+                ? gnThreadsActive - iThread
+                : (gnThreadsActive * aNodeCount[ iNode ] + nCpuTotal - 1) / nCpuTotal;
+            if (iThread + nThreads > gnThreadsActive)
+                nThreads = gnThreadsActive - iThread;
+
+            for( int i = 0; i < nThreads; i++, iThread++ )
+            {
+                gaThreadCore[ iThread ] = aNodeCpu[ iNode ][ i % aNodeCount[ iNode ] ];
+                gaThreadNode[ iThread ] = iNode;
+            }
+        }
+    }
+
+    // Call inside a parallel region
+    // ========================================================================
+    void Threads_PinSelf( const int iThread )
+    {
+        const int core = gaThreadCore[ iThread ];
+#if _WIN32
+        if (core < 64)
+            SetThreadAffinityMask( GetCurrentThread(), ((DWORD_PTR)1) << core );
+#else
+        cpu_set_t mask;
+        CPU_ZERO( &mask );
+        CPU_SET( core, &mask );
+        if (sched_setaffinity( 0, sizeof( mask ), &mask ) != 0)
+            printf( "WARNING: Couldn't pin thread %d to core %d\n", iThread, core );
+#endif
+    }
+
+    // Pins every thread and gives each node its own copy of table,
+    // first touched by a thread running on that node.
+    // Threads then use aReplicas[ gaThreadNode[ iThread ] ].
+    // ========================================================================
+    void Threads_Numa( const void *table, const size_t size, const void **aReplicas )
+    {
+        for( int iNode = 0; iNode < MAX_NODES; iNode++ )
+            aReplicas[ iNode ] = table;
+
+        if (!gbThreadsNuma)
+            return;
+
+        Threads_Topology();
+
+#pragma omp parallel
+        {
+            const int iThread = omp_get_thread_num();
+            const int iNode   = gaThreadNode[ iThread ];
+
+            Threads_PinSelf( iThread );
+
+            if ((iThread == 0) || (gaThreadNode[ iThread - 1 ] != iNode))
+            {
+                // Page aligned so the copy doesn't share a page touched by another node
+                void *copy = NULL;
+#if _WIN32
+                copy = VirtualAlloc( NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE );
+#else
+                if (posix_memalign( &copy, 4096, size ) != 0)
+                    copy = NULL;
+#endif
+                if (copy)
+                {
+                    memcpy( copy, table, size );
+                    aReplicas[ iNode ] = copy;
+                }
+            }
+        }
+
+        printf( "NUMA: %d node(s), threads pinned:", gnNumaNodes );
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+            printf( " %d@%d", gaThreadCore[ iThread ], gaThreadNode[ iThread ] );
+        printf( "\n" );
+    }
@@ -0,0 +1,162 @@
+/*
+
+"CRC32 Demystified"
+https://github.com/Michaelangel007/crc32
+
+Michaelangel007
+Copyleft (C) 2017
+
+Host specific settings written by bin/autotune, read at startup.
+
+The fastest kernel, chunk size, and thread count depend on the
+microarchitecture and the L1/L2 sizes, so they are measured once per
+host and saved as a small text file:
+
+    # autotune: Intel(R) Xeon(R) Processor
+    kernel       = zlib crc32
+    kernel_small = crc32_reverse
+    small_size   = 64
+    chunk        = 262144
+    threads      = 4
+
+The file is $CRC32_TUNE, else crc32.tune in the current directory.
+Missing file, keys, or kernels not built into this binary keep the
+defaults. Kernels are looked up by name in crc32_kernels.h, and only
+CRC32 B kernels, reference_crc32b, are used by Tune_Crc32B().
+
+Must include crc32_kernels.h first.
+
+*/
+
+// Consts
+
+    const char *TUNE_FILE = "crc32.tune";
+    const char *TUNE_ENV  = "CRC32_TUNE";
+
+// Types
+
+    struct Tune
+    {
+        char   kernel      [ 32 ]; // CRC32 B, lengths > small_size
+        char   kernel_small[ 32 ]; // CRC32 B, lengths <= small_size
+        size_t small_size;
+        size_t chunk     ; // bytes read and hashed at a time
+        int    threads   ; // 0 = all
+
+        // Resolved by Tune_Load()
+        Crc32Func func      ;
+        Crc32Func func_small;
+    };
+
+// Vars
+
+    Tune gTune =
+    {
+         "crc32_reverse"
+        ,"crc32_reverse"
+        ,0
+        ,1 << 20
+        ,0
+        ,crc32_reverse
+        ,crc32_reverse
+    };
+
+// Implementation
+
+    // @return CRC32 B kernel, NULL if it isn't in this binary
+    // ========================================================================
+    const Crc32Kernel* Tune_FindKernel( const char *name )
+    {
+        for( int iKernel = 0; iKernel < nKernels; iKernel++ )
+            if (!strcmp( aKernels[ iKernel ].name, name ) && (aKernels[ iKernel ].reference == reference_crc32b))
+                return &aKernels[ iKernel ];
+        return NULL;
+    }
+
+    // ========================================================================
+    const char* Tune_FileName()
+    {
+        const char *env = getenv( TUNE_ENV );
+        return (env && *env) ? env : TUNE_FILE;
+    }
+
+    // Strips leading and trailing whitespace in place
+    // ========================================================================
+    char* Tune_Trim( char *text )
+    {
+        while( (*text == ' ') || (*text == '\t') )
+            text++;
+
+        size_t length = strlen( text );
+        while( length && ((text[ length-1 ] == ' ') || (text[ length-1 ] == '\t') || (text[ length-1 ] == '\r') || (text[ length-1 ] == '\n')) )
+            text[ --length ] = 0;
+        return text;
+    }
+
+    // @param filename - NULL = Tune_FileName()
+    // @return false if there was no file, gTune keeps the defaults
+    // ========================================================================
+    bool Tune_Load( const char *filename = NULL )
+    {
+        if (!filename)
+            filename = Tune_FileName();
+
+        FILE *pFile = fopen( filename, "r" );
+        if (!pFile)
+            return false;
+
+        char line[ 256 ];
+        while( fgets( line, sizeof( line ), pFile ) )
+        {
+            char *equal = strchr( line, '=' );
+            if ((line[0] == '#') || !equal)
+                continue;
+
+            *equal = 0;
+            const char *key   = Tune_Trim( line      );
+            char       *value = Tune_Trim( equal + 1 );
+
+            if (!strcmp( key, "kernel"       ) && Tune_FindKernel( value )) strncpy( gTune.kernel      , value, sizeof( gTune.kernel       ) - 1 );
+            if (!strcmp( key, "kernel_small" ) && Tune_FindKernel( value )) strncpy( gTune.kernel_small, value, sizeof( gTune.kernel_small ) - 1 );
+            if (!strcmp( key, "small_size"   )) gTune.small_size = (size_t) strtoull( value, NULL, 10 );
+            if (!strcmp( key, "chunk"        )) gTune.chunk      = (size_t) strtoull( value, NULL, 10 );
+            if (!strcmp( key, "threads"      )) gTune.threads    = atoi( value );
+        }
+        fclose( pFile );
+
+        if (gTune.chunk < 4096)
+            gTune.chunk = 4096;
+        if (gTune.threads < 0)
+            gTune.threads = 0;
+
+        gTune.func       = Tune_FindKernel( gTune.kernel       )->func;
+        gTune.func_small = Tune_FindKernel( gTune.kernel_small )->func;
+        return true;
+    }
+
+    // ========================================================================
+    bool Tune_Save( const char *filename, const char *cpu )
+    {
+        FILE *pFile = fopen( filename, "w" );
+        if (!pFile)
+            return false;
+
+        fprintf( pFile, "# autotune: %s\n", cpu );
+        fprintf( pFile, "kernel       = %s\n"  , gTune.kernel       );
+        fprintf( pFile, "kernel_small = %s\n"  , gTune.kernel_small );
+        fprintf( pFile, "small_size   = %llu\n", (unsigned long long) gTune.small_size );
+        fprintf( pFile, "chunk        = %llu\n", (unsigned long long) gTune.chunk      );
+        fprintf( pFile, "threads      = %d\n"  , gTune.threads      );
+        fclose( pFile );
+        return true;
+    }
+
+    // CRC32 B with the tuned kernel for the length
+    // ========================================================================
+    inline uint32_t Tune_Crc32B( size_t len, const unsigned char *data )
+    {
+        LATENCY_SCOPE( "Tune_Crc32B", len );
+        return (len <= gTune.small_size)
+            ? gTune.func_small( len, data )
+            : gTune.func      ( len, data );
+    }